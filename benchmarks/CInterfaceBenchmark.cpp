@@ -0,0 +1,67 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+#include <cppIni/cppIni_c.h>
+
+#include "bench.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+BENCHMARK("C API: cppIni_get and cppIni_set vs. File")
+{
+    constexpr std::size_t operations = 200'000;
+
+    const bench::GeneratedFile file(100, 1'000);
+    std::printf(" 100 sections x 1000 entries (%.1f MB)\n", file.size() / 1e6);
+
+    std::vector<std::pair<std::string, std::string>> integers;
+    for (std::size_t section = 0; section < 100; ++section) {
+        for (std::size_t entry = 0; entry < 1'000; entry += 3) {
+            integers.emplace_back(std::format("Section{}", section), std::format("Int{}", entry));
+        }
+    }
+
+    std::ranges::shuffle(integers, std::mt19937{42});
+
+    const File f{file.filename()};
+    auto ini = cppIni_open(file.filename().c_str());
+
+    bench::measure("File::get<int>()", operations, 0, [&, next = std::size_t{0}]() mutable {
+        const auto& [section, key] = integers[next++ % integers.size()];
+        bench::doNotOptimize(f.get<int>(section, key));
+    });
+    bench::measure("cppIni_geti()", operations, 0, [&, next = std::size_t{0}]() mutable {
+        const auto& [section, key] = integers[next++ % integers.size()];
+        bench::doNotOptimize(cppIni_geti(ini, section.c_str(), key.c_str()));
+    });
+    bench::measure("cppIni_gets()", operations, 0, [&, next = std::size_t{0}, buffer = std::array<char, 64>{}]() mutable {
+        const auto& [section, key] = integers[next++ % integers.size()];
+        bench::doNotOptimize(cppIni_gets(ini, section.c_str(), key.c_str(), buffer.data(), buffer.size()));
+    });
+
+    // Every cppIni_set() writes the change to the file
+    bench::measure("cppIni_set()", 1'000, 0, [&, next = std::size_t{0}]() mutable {
+        const auto& [section, key] = integers[next++ % integers.size()];
+        cppIni_set(ini, section.c_str(), key.c_str(), "42");
+    });
+
+    cppIni_close(&ini);
+}
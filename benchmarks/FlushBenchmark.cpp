@@ -0,0 +1,48 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+
+#include "bench.h"
+
+BENCHMARK("Flush: patch vs. full rewrite")
+{
+    const bench::GeneratedFile file(100, 10'000);
+    std::printf(" 100 sections x 10000 entries (%.1f MB)\n", file.size() / 1e6);
+
+    File f{file.filename()};
+    auto value = 0;
+
+    const auto rewrite = bench::measure("Full rewrite", 5, file.size(), [&] {
+        f.getSection("Section99")->setEntry({"Int3", ++value % 10});
+        f.flush();
+    });
+    const auto sameLength = bench::measure("Patch, same length", 100, 0, [&] {
+        f.set("Section0", "Int3", ++value % 10);
+    });
+    const auto appended = bench::measure("Patch, new entry in last section", 100, 0, [&] {
+        ++value;
+        f.set("Section99", std::format("New{}", value), value);
+    });
+    const auto tail = bench::measure("Patch, length change in last section", 100, 0, [&] {
+        f.set("Section99", "Int3", ++value % 2 ? 1 : 100);
+    });
+
+    std::printf("  speedup same length %.0fx, new entry %.0fx, length change %.0fx\n",
+                rewrite / sameLength, rewrite / appended, rewrite / tail);
+}
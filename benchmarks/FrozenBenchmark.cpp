@@ -0,0 +1,63 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+#include <cppIni/FrozenFile.h>
+
+#include "bench.h"
+
+#include <algorithm>
+#include <random>
+
+BENCHMARK("Frozen: lookup in a File vs. a FrozenFile")
+{
+    const bench::GeneratedFile file(100, 1'000);
+    std::printf(" 100 sections x 1000 entries (%.1f MB)\n", file.size() / 1e6);
+
+    const File f{file.filename()};
+
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (const auto section : f.sections()) {
+        for (const auto& [key, _] : section->entries()) {
+            keys.emplace_back(section->fqTitle(), key);
+        }
+    }
+
+    std::ranges::shuffle(keys, std::mt19937{42});
+
+    bench::measure("Freeze", 5, 0, [&] {
+        bench::doNotOptimize(f.freeze().size());
+    });
+
+    const auto frozen = f.freeze();
+
+    bench::measure("Look up all entries in the File", 20, 0, [&] {
+        std::size_t found = 0;
+        for (const auto& [section, key] : keys) {
+            found += f.findEntry(section, key) != nullptr;
+        }
+        bench::doNotOptimize(found);
+    });
+    bench::measure("Look up all entries in the FrozenFile", 20, 0, [&] {
+        std::size_t found = 0;
+        for (const auto& [section, key] : keys) {
+            found += frozen.findEntry(section, key) != nullptr;
+        }
+        bench::doNotOptimize(found);
+    });
+}
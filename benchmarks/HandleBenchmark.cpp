@@ -0,0 +1,70 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+
+#include "bench.h"
+
+#include <algorithm>
+#include <random>
+
+BENCHMARK("Handle: lookup by name vs. key handles")
+{
+    const bench::GeneratedFile file(100, 1'000);
+    std::printf(" 50 keys of 100 sections x 1000 entries read 200000 times\n");
+
+    for (const auto threadSafe : {false, true}) {
+        const File f{file.filename(), {.threadSafe = threadSafe}};
+
+        std::vector<std::pair<std::string, std::string>> keys;
+        for (const auto section : f.sections()) {
+            for (const auto& [key, _] : section->entries()) {
+                keys.emplace_back(section->fqTitle(), key);
+            }
+        }
+
+        std::ranges::shuffle(keys, std::mt19937{42});
+        keys.resize(50);
+
+        std::vector<KeyHandle> handles;
+        for (const auto& [section, key] : keys) {
+            handles.push_back(f.keyHandle(section, key));
+        }
+
+        std::printf(" %s\n", threadSafe ? "Thread-safe" : "Not thread-safe");
+
+        bench::measure("Look up the keys by name", 5, 0, [&] {
+            std::size_t length = 0;
+            for (auto i = 0; i < 4'000; ++i) {
+                for (const auto& [section, key] : keys) {
+                    length += f.get<std::string_view>(section, key).size();
+                }
+            }
+            bench::doNotOptimize(length);
+        });
+        bench::measure("Read the keys through handles", 5, 0, [&] {
+            std::size_t length = 0;
+            for (auto i = 0; i < 4'000; ++i) {
+                for (const auto& handle : handles) {
+                    length += handle.get<std::string_view>().size();
+                }
+            }
+            bench::doNotOptimize(length);
+        });
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+
+#include "bench.h"
+
+BENCHMARK("Layout: iteration and lookup")
+{
+    const bench::GeneratedFile file(100, 1'000);
+    std::printf(" 100 sections x 1000 entries (%.1f MB)\n", file.size() / 1e6);
+
+    const File f{file.filename()};
+    const File other{file.filename()};
+
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (const auto section : f.sections()) {
+        for (const auto& [key, _] : section->entries()) {
+            keys.emplace_back(section->fqTitle(), key);
+        }
+    }
+
+    bench::measure("Iterate all entries", 20, 0, [&] {
+        std::size_t bytes = 0;
+        for (const auto section : f.sections()) {
+            for (const auto& [key, entry] : section->entries()) {
+                bytes += key.size() + entry.data().size();
+            }
+        }
+        bench::doNotOptimize(bytes);
+    });
+    bench::measure("Look up all entries", 20, 0, [&] {
+        std::size_t found = 0;
+        for (const auto& [section, key] : keys) {
+            found += f.findEntry(section, key) != nullptr;
+        }
+        bench::doNotOptimize(found);
+    });
+    bench::measure("Compare two files", 20, 0, [&] {
+        bench::doNotOptimize(f == other);
+    });
+}
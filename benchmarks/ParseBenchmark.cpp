@@ -0,0 +1,200 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+
+#include "bench.h"
+
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+BENCHMARK("Parse: stream vs. memory mapping")
+{
+    for (const auto& [sections, entries] : {std::pair{100, 10'000}, std::pair{20'000, 50}}) {
+        const bench::GeneratedFile file(sections, entries);
+        std::printf(" %d sections x %d entries (%.1f MB)\n", sections, entries, file.size() / 1e6);
+
+        const auto streamed = bench::measure("LoadMode::Stream", 5, file.size(), [&] {
+            const File f{file.filename(), {.loadMode = LoadMode::Stream}};
+            bench::doNotOptimize(f);
+        });
+        const auto mapped = bench::measure("LoadMode::Mapped", 5, file.size(), [&] {
+            const File f{file.filename(), {.loadMode = LoadMode::Mapped}};
+            bench::doNotOptimize(f);
+        });
+
+        std::printf("  speedup %.2fx\n", streamed / mapped);
+    }
+}
+
+BENCHMARK("Parse: heap vs. arena")
+{
+    const bench::GeneratedFile file(100, 10'000);
+    std::printf(" 100 sections x 10000 entries (%.1f MB)\n", file.size() / 1e6);
+
+    for (const auto loadMode : {LoadMode::Stream, LoadMode::Mapped}) {
+        std::printf(" %s\n", loadMode == LoadMode::Stream ? "LoadMode::Stream" : "LoadMode::Mapped");
+
+        const auto heap = bench::measure("Load and destroy on the heap", 5, file.size(), [&] {
+            const File f{file.filename(), {.loadMode = loadMode}};
+            bench::doNotOptimize(f);
+        });
+        const auto arena = bench::measure("Load and destroy in an arena", 5, file.size(), [&] {
+            const File f{file.filename(), {.loadMode = loadMode, .arena = true}};
+            bench::doNotOptimize(f);
+        });
+
+        std::printf("  speedup %.2fx\n", heap / arena);
+    }
+}
+
+BENCHMARK("Parse: text vs. binary cache")
+{
+    for (const auto& [sections, entries] : {std::pair{100, 10'000}, std::pair{20'000, 50}}) {
+        const bench::GeneratedFile file(sections, entries);
+        std::printf(" %d sections x %d entries (%.1f MB)\n", sections, entries, file.size() / 1e6);
+
+        File{file.filename()}.writeCache();
+
+        const auto streamed = bench::measure("Parse LoadMode::Stream", 5, file.size(), [&] {
+            const File f{file.filename(), {.loadMode = LoadMode::Stream}};
+            bench::doNotOptimize(f);
+        });
+        const auto mapped = bench::measure("Parse LoadMode::Mapped", 5, file.size(), [&] {
+            const File f{file.filename(), {.loadMode = LoadMode::Mapped}};
+            bench::doNotOptimize(f);
+        });
+        const auto cached = bench::measure("Load the binary cache", 5, file.size(), [&] {
+            const File f{file.filename(), {.cache = true}};
+            bench::doNotOptimize(f);
+        });
+
+        std::printf("  speedup %.2fx (stream), %.2fx (mapped)\n", streamed / cached, mapped / cached);
+        std::filesystem::remove(file.filename() + ".cache");
+    }
+}
+
+BENCHMARK("Parse: throughput per thread count")
+{
+    const auto cores = std::max(1u, std::thread::hardware_concurrency());
+    std::printf(" %u cores\n", cores);
+
+    for (const auto& [sections, entries] : {std::pair{100, 10'000}, std::pair{20'000, 50}}) {
+        const bench::GeneratedFile file(sections, entries);
+        std::printf(" %d sections x %d entries (%.1f MB)\n", sections, entries, file.size() / 1e6);
+
+        auto single = 0.0;
+        for (auto threads = 1u; threads <= std::max(cores, 2u); threads *= 2) {
+            const auto seconds = bench::measure(std::format("LoadMode::Mapped, {} threads", threads), 5, file.size(), [&] {
+                const File f{file.filename(), {.loadMode = LoadMode::Mapped, .parseThreads = threads}};
+                bench::doNotOptimize(f);
+            });
+
+            single = threads == 1 ? seconds : single;
+            std::printf("  speedup %.2fx\n", single / seconds);
+        }
+    }
+}
+
+BENCHMARK("Parse: reopen vs. reload after a one-line change")
+{
+    const bench::GeneratedFile file(100, 10'000);
+    std::printf(" 100 sections x 10000 entries (%.1f MB)\n", file.size() / 1e6);
+
+    const auto original = [&file] {
+        std::ifstream in{file.filename(), std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{in}, {}};
+    }();
+    auto changed = original;
+    changed.replace(changed.find("Int0=0"), 6, "Int0=1");
+
+    auto round = 0;
+    const auto edit = [&] {
+        std::ofstream out{file.filename(), std::ios::binary};
+        out << (++round % 2 ? changed : original);
+    };
+
+    const auto reopened = bench::measure("Edit and open a new File", 5, file.size(), [&] {
+        edit();
+        const File f{file.filename()};
+        bench::doNotOptimize(f);
+    });
+
+    File f{file.filename()};
+    const auto reloaded = bench::measure("Edit and reload the File", 5, file.size(), [&] {
+        edit();
+        f.reload();
+        bench::doNotOptimize(f);
+    });
+
+    std::printf("  speedup %.2fx\n", reopened / reloaded);
+}
+
+BENCHMARK("Parse: File vs. Parser callbacks")
+{
+    /// \brief Extracts a single value like a tool that only needs a few keys
+    struct Finder {
+        std::size_t entries {0};
+        std::string_view value {};
+
+        auto entry(const ParsedEntry& entry) -> void
+        {
+            ++entries;
+            if (entry.section == "Section99" and entry.key == "String9998") {
+                value = entry.value;
+            }
+        }
+    };
+
+    const bench::GeneratedFile file(100, 10'000);
+    std::printf(" 100 sections x 10000 entries (%.1f MB)\n", file.size() / 1e6);
+
+    const auto built = bench::measure("File with LoadMode::Stream", 5, file.size(), [&] {
+        const File f{file.filename(), {.loadMode = LoadMode::Stream}};
+        bench::doNotOptimize(f);
+    });
+    const auto streamed = bench::measure("Parser without a tree", 5, file.size(), [&] {
+        auto finder = Finder{};
+        Parser::parse(file.filename(), finder);
+        bench::doNotOptimize(finder);
+    });
+
+    std::printf("  speedup %.2fx\n", built / streamed);
+}
+
+BENCHMARK("Parse: eager vs. lazy open, then read three sections")
+{
+    const bench::GeneratedFile file(50'000, 20);
+    std::printf(" 50000 sections x 20 entries (%.1f MB)\n", file.size() / 1e6);
+
+    const auto read = [](const File& f) {
+        return f.get<int>("Section7", "Int3") + f.get<int>("Section25000", "Int3") + f.get<int>("Section49999", "Int3");
+    };
+
+    const auto eager = bench::measure("LoadMode::Mapped", 5, file.size(), [&] {
+        const File f{file.filename(), {.loadMode = LoadMode::Mapped}};
+        bench::doNotOptimize(read(f));
+    });
+    const auto lazy = bench::measure("LoadMode::Lazy", 5, file.size(), [&] {
+        const File f{file.filename(), {.loadMode = LoadMode::Lazy}};
+        bench::doNotOptimize(read(f));
+    });
+
+    std::printf("  speedup %.2fx\n", eager / lazy);
+}
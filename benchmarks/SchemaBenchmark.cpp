@@ -0,0 +1,73 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+#include <cppIni/Schema.h>
+
+#include "bench.h"
+
+namespace
+{
+struct Settings {
+    int int0 {};
+    double double1 {};
+    std::string string2 {};
+    int int3 {};
+    double double4 {};
+};
+
+using SettingsSchema = Schema<Settings,
+                              Field<"Section50", "Int0", &Settings::int0>,
+                              Field<"Section50", "Double1", &Settings::double1>,
+                              Field<"Section50", "String2", &Settings::string2>,
+                              Field<"Section99", "Int3", &Settings::int3>,
+                              Field<"Section99", "Double4", &Settings::double4>>;
+}
+
+BENCHMARK("Schema: get<T>() per read vs. a loaded struct")
+{
+    constexpr std::size_t iterations = 1'000'000;
+
+    const bench::GeneratedFile file(100, 100);
+    const File f{file.filename()};
+
+    bench::measure("five get<T>() calls", iterations, 0, [&] {
+        bench::doNotOptimize(f.get<int>("Section50", "Int0"));
+        bench::doNotOptimize(f.get<double>("Section50", "Double1"));
+        bench::doNotOptimize(f.get<std::string_view>("Section50", "String2"));
+        bench::doNotOptimize(f.get<int>("Section99", "Int3"));
+        bench::doNotOptimize(f.get<double>("Section99", "Double4"));
+    });
+
+    bench::measure("SettingsSchema::load()", iterations / 10, 0, [&] {
+        bench::doNotOptimize(SettingsSchema::load(f));
+    });
+
+    const auto settings = SettingsSchema::load(f);
+    bench::measure("five member reads", iterations, 0, [&] {
+        bench::doNotOptimize(settings.int0);
+        bench::doNotOptimize(settings.double1);
+        bench::doNotOptimize(settings.string2.size());
+        bench::doNotOptimize(settings.int3);
+        bench::doNotOptimize(settings.double4);
+    });
+
+    bench::measure("SettingsSchema::parse() of the text", 5, file.size(), [&] {
+        bench::doNotOptimize(SettingsSchema::parse(file.filename()));
+    });
+}
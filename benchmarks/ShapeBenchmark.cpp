@@ -0,0 +1,82 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/File.h>
+
+#include "bench.h"
+
+#include <algorithm>
+#include <random>
+
+BENCHMARK("Shapes: parse, look up, read and change")
+{
+    constexpr std::size_t operations = 200'000;
+
+    for (const auto& shape : bench::shapes()) {
+        const bench::GeneratedFile file(shape);
+        std::printf(" %s: %zu sections x %zu entries, %zu levels deep (%.1f MB)\n", std::string(shape.name).c_str(),
+                    shape.sections, shape.entries, shape.depth, file.size() / 1e6);
+
+        bench::measure("Parse a stream", 3, file.size(), [&] {
+            const File f{file.filename(), {.autoFlush = false}};
+            bench::doNotOptimize(f.sections().size());
+        });
+        bench::measure("Parse a mapping", 3, file.size(), [&] {
+            const File f{file.filename(), {.loadMode = LoadMode::Mapped, .autoFlush = false}};
+            bench::doNotOptimize(f.sections().size());
+        });
+
+        File f{file.filename(), {.autoFlush = false}};
+
+        std::vector<std::pair<std::string, std::string>> keys;
+        std::vector<std::pair<std::string, std::string>> integers;
+        for (const auto section : f.sections()) {
+            for (const auto& [key, _] : section->entries()) {
+                keys.emplace_back(section->fqTitle(), key);
+
+                if (key.starts_with("Int")) {
+                    integers.emplace_back(section->fqTitle(), key);
+                }
+            }
+        }
+
+        std::ranges::shuffle(keys, std::mt19937{42});
+        std::ranges::shuffle(integers, std::mt19937{42});
+
+        // Every call is one operation on the next key, so the results are latencies
+        bench::measure("findEntry()", operations, 0, [&, next = std::size_t{0}]() mutable {
+            const auto& [section, key] = keys[next++ % keys.size()];
+            bench::doNotOptimize(f.findEntry(section, key));
+        });
+        bench::measure("get<std::string_view>()", operations, 0, [&, next = std::size_t{0}]() mutable {
+            const auto& [section, key] = keys[next++ % keys.size()];
+            bench::doNotOptimize(f.get<std::string_view>(section, key));
+        });
+        bench::measure("get<int>()", operations, 0, [&, next = std::size_t{0}]() mutable {
+            const auto& [section, key] = integers[next++ % integers.size()];
+            bench::doNotOptimize(f.get<int>(section, key));
+        });
+        bench::measure("set() without flush", operations, 0, [&, next = std::size_t{0}]() mutable {
+            const auto& [section, key] = integers[next % integers.size()];
+            f.set(section, key, static_cast<int>(next++ % 1'000));
+        });
+        bench::measure("flush() of all changes", 1, file.size(), [&] {
+            f.flush();
+        });
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/Entry.h>
+
+#include "bench.h"
+
+BENCHMARK("Entry::value: cached vs. uncached reads")
+{
+    constexpr std::size_t iterations = 10'000'000;
+
+    const Entry integer{"Timeout", "123456789"};
+    const Entry floating{"Ratio", "0.123456789"};
+
+    bench::measure("value<int>() cached", iterations, 0, [&] {
+        bench::doNotOptimize(integer.value<int>());
+    });
+    bench::measure("value<double>() cached", iterations, 0, [&] {
+        bench::doNotOptimize(floating.value<double>());
+    });
+
+    // Alternating between two types replaces the cached value on every read, so every read parses the text.
+    bench::measure("value<int>() / value<long>() uncached", iterations, 0, [&, odd = false]() mutable {
+        bench::doNotOptimize((odd = !odd) ? integer.value<int>() : integer.value<long>());
+    });
+    bench::measure("value<double>() / value<float>() uncached", iterations, 0, [&, odd = false]() mutable {
+        bench::doNotOptimize((odd = !odd) ? floating.value<double>() : floating.value<float>());
+    });
+}
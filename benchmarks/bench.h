@@ -0,0 +1,196 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench
+{
+
+/// \brief A registered benchmark
+struct Benchmark
+{
+    std::string_view name;
+    void (*function)();
+};
+
+/// \brief List of all benchmarks registered with the BENCHMARK macro
+inline auto registry() -> std::vector<Benchmark>&
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+/// \brief Adds a benchmark to the registry during static initialization
+struct Registrar
+{
+    Registrar(std::string_view name, void (*function)()) { registry().push_back({name, function}); }
+};
+
+/// \brief Prevents the compiler from optimizing away a computed value
+template<class T>
+inline auto doNotOptimize(const T& value) -> void
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+/// \brief Number of calls to the global operator new since the start of the benchmark executable
+///
+/// \details Counts every form of operator new, including the aligned ones used by the memory resources of a File.
+auto allocations() -> std::size_t;
+
+/// \brief Runs a function repeatedly and prints the mean wall time and the allocations per iteration
+///
+/// \details If a call processes a known number of bytes, the time is printed in milliseconds together with the
+///          throughput. Otherwise a call is a single operation and its latency is printed in nanoseconds.
+///
+/// \param label The label printed in front of the result
+/// \param iterations The number of times the function is called
+/// \param bytes The number of bytes processed per call, used to print the throughput (0 to omit it)
+/// \param function The function to measure
+/// \returns The mean duration of a single call in seconds
+template<class F>
+auto measure(std::string_view label, std::size_t iterations, std::size_t bytes, F&& function) -> double
+{
+    const auto allocated = allocations();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / iterations;
+    const auto perCall = static_cast<double>(allocations() - allocated) / iterations;
+
+    if (bytes > 0) {
+        std::printf("  %-40s %12.3f ms %10.1f MB/s %12.1f allocs\n", std::string(label).c_str(), seconds * 1e3, bytes / seconds / 1e6, perCall);
+    } else {
+        std::printf("  %-40s %12.3f ns %15s %12.1f allocs\n", std::string(label).c_str(), seconds * 1e9, "", perCall);
+    }
+
+    return seconds;
+}
+
+/// \brief Shape of a generated INI file
+struct Shape
+{
+    std::string_view name; ///< Printed in front of the results
+    std::size_t sections; ///< Number of top-level sections
+    std::size_t entries; ///< Number of entries of every section and subsection
+    std::size_t depth {0}; ///< Number of nested subsections below every top-level section
+    std::size_t valueLength {0}; ///< Length of the string values, 0 for a short sentence
+};
+
+/// \brief Shapes that stress different parts of the library
+///
+/// \details All of them have a few megabytes, so their throughputs can be compared with each other.
+inline auto shapes() -> std::vector<Shape>
+{
+    return {
+        {"Few huge sections", 4, 50'000},
+        {"Many small sections", 50'000, 4},
+        {"Deep subsections", 2'000, 4, 8},
+        {"Long values", 100, 300, 0, 1'000},
+    };
+}
+
+/// \brief Class for managing the lifetime of a generated INI file
+///
+/// \details The file is written to the temporary directory during construction and deleted when the object goes out of
+///          scope. Every section has the given number of entries with integer, floating point and string values.
+///          Subsections are named "Section<n>.Level1.Level2" and so on. The content only depends on the shape, so
+///          every run measures the same file.
+class GeneratedFile
+{
+public:
+    GeneratedFile(std::size_t sections, std::size_t entriesPerSection)
+        : GeneratedFile(Shape{"", sections, entriesPerSection})
+    {}
+
+    explicit GeneratedFile(const Shape& shape)
+        : m_path(std::filesystem::temp_directory_path() / std::format("cppIni_bench_{}x{}x{}_{}.ini", shape.sections, shape.entries, shape.depth, shape.valueLength))
+    {
+        std::ofstream file{m_path};
+        auto title = std::string{};
+
+        for (std::size_t s = 0; s < shape.sections; ++s) {
+            title = std::format("Section{}", s);
+
+            for (std::size_t level = 0; level <= shape.depth; ++level) {
+                if (level > 0) {
+                    title += std::format(".Level{}", level);
+                }
+
+                file << '[' << title << "]\n";
+                for (std::size_t e = 0; e < shape.entries; ++e) {
+                    switch (e % 3) {
+                        case 0: file << "Int" << e << '=' << s * e << '\n'; break;
+                        case 1: file << "Double" << e << '=' << s * 0.25 + e << '\n'; break;
+                        default: file << "String" << e << '=' << value(shape.valueLength, s, e) << '\n'; break;
+                    }
+                }
+                file << '\n';
+            }
+        }
+    }
+    ~GeneratedFile() { std::filesystem::remove(m_path); }
+
+    GeneratedFile(const GeneratedFile&) = delete;
+    auto operator=(const GeneratedFile&) -> GeneratedFile& = delete;
+
+    auto filename() const -> std::string { return m_path.string(); }
+    auto size() const -> std::size_t { return std::filesystem::file_size(m_path); }
+
+private:
+    /// \returns A string value of the given length, or a short sentence naming the section if the length is 0
+    static auto value(std::size_t length, std::size_t section, std::size_t entry) -> std::string
+    {
+        if (length == 0) {
+            return std::format("Some value of section {}", section);
+        }
+
+        auto text = std::string(length, ' ');
+        for (std::size_t i = 0; i < length; ++i) {
+            text[i] = static_cast<char>('a' + (section + entry + i * 7) % 26);
+        }
+        return text;
+    }
+
+    std::filesystem::path m_path;
+};
+}
+
+#define BENCH_CAT_IMPL(a, b) a##b
+#define BENCH_CAT(a, b) BENCH_CAT_IMPL(a, b)
+
+/// \brief Defines and registers a benchmark function
+#define BENCHMARK(name) \
+    static void BENCH_CAT(benchmark_, __LINE__)(); \
+    static const bench::Registrar BENCH_CAT(registrar_, __LINE__){name, BENCH_CAT(benchmark_, __LINE__)}; \
+    static void BENCH_CAT(benchmark_, __LINE__)()
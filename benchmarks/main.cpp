@@ -0,0 +1,92 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> allocationCount{0};
+
+auto bench::allocations() -> std::size_t
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (const auto memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    // aligned_alloc requires the size to be a multiple of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    const auto rounded = ((size == 0 ? 1 : size) + align - 1) / align * align;
+    if (const auto memory = std::aligned_alloc(align, rounded)) {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+/// Runs every registered benchmark whose name contains the first command line argument (or all of them).
+int main(int argc, char** argv)
+{
+    const std::string_view filter = argc > 1 ? argv[1] : "";
+
+    for (const auto& [name, function] : bench::registry()) {
+        if (name.find(filter) == std::string_view::npos) {
+            continue;
+        }
+
+        std::printf("%s\n", std::string(name).c_str());
+        function();
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -63,17 +63,21 @@ class cppiniRecipe(ConanFile):
         "shared": [True, False],
         "fPIC": [True, False],
         "testing": [True, False],
+        "benchmarks": [True, False],
+        "statistics": [True, False],
         "coverage": [True, False]
     }
     default_options = {
         "shared": False,
         "fPIC": True,
         "testing": True,
+        "benchmarks": False,
+        "statistics": True,
         "coverage": False
     }
 
     # Sources are located in the same place as this recipe, copy them to the recipe
-    exports_sources = "CMakeLists.txt", "src/*", "include/*", "cmake/*", "tests/*"
+    exports_sources = "CMakeLists.txt", "src/*", "include/*", "cmake/*", "tests/*", "benchmarks/*"
 
     def build_requirements(self):
         self.build_requires("cmake/[>=3.24]")
@@ -101,6 +105,8 @@ class cppiniRecipe(ConanFile):
         tc = CMakeToolchain(self)
         tc.variables["BUILD_SHARED_LIBS"] = self.options.shared
         tc.variables["BUILD_TESTING"] = self.options.testing
+        tc.variables["BUILD_BENCHMARKS"] = self.options.benchmarks
+        tc.variables["CPPINI_STATISTICS"] = self.options.statistics
         tc.variables["CODE_COVERAGE"] = self.options.coverage
         tc.generate()
 
@@ -116,3 +122,4 @@ class cppiniRecipe(ConanFile):
 
     def package_info(self):
         self.cpp_info.libs = ["cppini"]
+        self.cpp_info.defines = ["CPPINI_STATISTICS={}".format(1 if self.options.statistics else 0)]
@@ -19,7 +19,19 @@
 #pragma once
 
 #include <cppIni/cppini_export.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <system_error>
+#include <tuple>
+#include <variant>
 
 class Section;
 
@@ -27,55 +39,268 @@ class Section;
 /// \details An entry is a key-value pair. The key is a string and the value can be any type. It has a parent Section
 /// held by a (non-owning) pointer.
 /// \note The value is stored as a string.
-/// \note The value is copied into the Entry and not moved.
+/// \note A std::string value is moved into the Entry, every other value is copied or converted to text.
 /// \note The parent Section is a pointer to the Section object that contains this Entry.
+/// \note Entries created by a File may borrow their key and value from storage owned by that File (e.g. a memory
+/// mapping) instead of holding a copy. Such entries must not outlive the File. Changing the value with setData() always
+/// makes the Entry own its value.
+/// \note The last arithmetic value returned by value() or tryValue() is cached, so reading it again with the same type
+/// does not parse the text again.
 class CPPINI_EXPORT Entry {
 public:
     constexpr Entry() = default; ///< Default constructor
-    virtual ~Entry() = default; ///< Destructor
+    ~Entry() = default; ///< Destructor
 
     Entry(const Entry& other) = default; ///< Copy constructor
+    Entry(Entry&& other) noexcept = default; ///< Move constructor
 
     template<class T>
     constexpr Entry(std::string_view key, T value, Section* parent = nullptr); ///< Constructor with key, value and parent Section pointer (default nullptr)
 
-    auto key() const -> std::string_view { return m_key; } ///< Key as std::string_view
+    auto key() const -> std::string_view { return view(m_key); } ///< Key as std::string_view
     auto fqKey() const -> std::string; ///< Fully qualified key (e.g. "Section1.Section2.Key")
-    template<class T> auto value() const -> T; ///< Value as type T
-    auto data() const -> std::string_view { return m_data; } ///< Value as std::string_view
+    template<class T> auto value() const -> T; ///< Value as type T. Throws if the value cannot be converted.
+    template<class T> auto tryValue() const -> std::optional<T>; ///< Value as type T or std::nullopt if the value cannot be converted
+    auto data() const -> std::string_view { return view(m_data); } ///< Value as std::string_view
     constexpr auto parent() const -> const Section* { return m_parent; } ///< Parent Section
 
-    auto setKey(std::string_view key) -> void { m_key = key; } ///< Set the key
+    auto setKey(std::string_view key) -> void { m_key = std::string(key); } ///< Set the key
     template<class T> auto setData(T value) -> void; ///< Set the value
 
-    // FIXME Why does GCC 11.4.0 not like constexpr string comparison?
-    auto operator==(const Entry& other) const -> bool = default; ///< Equality operator
-    auto operator!=(const Entry& other) const -> bool = default; ///< Inequality operator
+    auto operator==(const Entry& other) const -> bool; ///< Equality operator
+    auto operator!=(const Entry& other) const -> bool { return !(*this == other); } ///< Inequality operator
 
     auto operator=(const Entry& other) -> Entry& = default; ///< Copy assignment operator
-    auto operator=(Entry&& other) -> Entry& = default; ///< Move assignment operator
+    auto operator=(Entry&& other) noexcept -> Entry& = default; ///< Move assignment operator
 
     template<class T>
     requires (not std::is_same_v<T, Entry>)
     auto operator=(T value) -> Entry& { setData(value); return *this; } ///< Assignment operator for setting the value
 
 private:
-    std::string m_key {};
-    std::string m_data {};
+    /// \brief Text that is either owned by the Entry or borrowed from storage that outlives it
+    using Text = std::variant<std::string, std::string_view>;
+
+    static auto view(const Text& text) -> std::string_view; ///< View on owned or borrowed text
+
+    template<class T> static auto toString(T value) -> std::string; ///< Text representation of an arithmetic value
+    template<class T> static auto fromString(std::string_view text, T& value) -> std::errc; ///< Convert text to an arithmetic value
+    static auto borrow(std::string_view key, std::string_view data, Section* parent) -> Entry; ///< Entry that references key and value without copying
+
+    /// \brief Cache for the last arithmetic value converted from the text
+    /// \details The cache is a sequence lock, so concurrent readers of a const Entry may fill and read it without a data
+    /// race. Types larger than 64 bits are not cached. Copies of the cache start empty.
+    class ValueCache {
+    public:
+        constexpr ValueCache() = default;
+        ValueCache(const ValueCache&) noexcept {}
+        auto operator=(const ValueCache&) noexcept -> ValueCache& { clear(); return *this; }
+
+        template<class T> auto load() const -> std::optional<T>; ///< Cached value if it was stored with type T
+        template<class T> auto store(T value) const -> void; ///< Replace the cached value unless another thread is storing one
+        auto clear() -> void { m_type.store(0, std::memory_order_relaxed); } ///< Drop the cached value. Requires exclusive access.
+
+    private:
+        using Types = std::tuple<bool, char, signed char, unsigned char, short, unsigned short, int, unsigned int, long,
+                                 unsigned long, long long, unsigned long long, float, double>;
+
+        template<class T> static constexpr auto typeId() -> std::uint8_t; ///< Position of T in Types plus one, 0 if not cacheable
+
+        mutable std::atomic<std::uint32_t> m_sequence {0}; ///< Odd while a value is being stored
+        mutable std::atomic<std::uint8_t> m_type {0};
+        mutable std::atomic<std::uint64_t> m_bits {0};
+    };
+
+    friend class File;
+    friend class FrozenFile;
+    friend class Section;
+    template<class T, class... Fields>
+    friend class Schema;
+
+    Text m_key {};
+    Text m_data {};
     Section* m_parent {nullptr};
+    ValueCache m_cache {};
+    std::size_t m_offset {std::string::npos}; ///< Position of the value in the file relative to the Section as last read or written
+    std::size_t m_length {0}; ///< Length of the value in the file as last read or written
 };
 
+template<class T>
+constexpr auto Entry::ValueCache::typeId() -> std::uint8_t
+{
+    return []<std::size_t... I>(std::index_sequence<I...>) {
+        std::uint8_t id = 0;
+        ((id = std::is_same_v<T, std::tuple_element_t<I, Types>> ? I + 1 : id), ...);
+        return id;
+    }(std::make_index_sequence<std::tuple_size_v<Types>>{});
+}
+
+/// \returns The cached value, or std::nullopt if the cache is empty, holds another type or is being written
+template<class T>
+auto Entry::ValueCache::load() const -> std::optional<T>
+{
+    if constexpr (typeId<T>() == 0) {
+        return std::nullopt;
+    } else {
+        const auto sequence = m_sequence.load(std::memory_order_acquire);
+        const auto type = m_type.load(std::memory_order_relaxed);
+        const auto bits = m_bits.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (sequence % 2 != 0 or type != typeId<T>() or m_sequence.load(std::memory_order_relaxed) != sequence) {
+            return std::nullopt;
+        }
+
+        return std::bit_cast<std::array<T, sizeof(std::uint64_t) / sizeof(T)>>(bits)[0];
+    }
+}
+
+/// \details If another thread is storing a value at the same time, this call does nothing. Both threads converted the
+/// same text, so it does not matter which value ends up in the cache.
+/// \arg value The value to cache
+template<class T>
+auto Entry::ValueCache::store(T value) const -> void
+{
+    if constexpr (typeId<T>() != 0) {
+        auto sequence = m_sequence.load(std::memory_order_relaxed);
+
+        if (sequence % 2 != 0 or not m_sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::array<T, sizeof(std::uint64_t) / sizeof(T)> buffer {value};
+        m_type.store(typeId<T>(), std::memory_order_relaxed);
+        m_bits.store(std::bit_cast<std::uint64_t>(buffer), std::memory_order_relaxed);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+}
+
+/// \param text The owned or borrowed text
+/// \returns A view on the text that is valid as long as its storage is
+inline auto Entry::view(const Text& text) -> std::string_view
+{
+    if (const auto borrowed = std::get_if<std::string_view>(&text)) {
+        return *borrowed;
+    }
+
+    return std::get<std::string>(text);
+}
+
+/// \details The key and value are not copied. The caller has to make sure that the referenced storage outlives the
+/// returned Entry and all copies of it.
+/// \arg key The key of the Entry
+/// \arg data The value of the Entry
+/// \arg parent The Section containing the Entry
+inline auto Entry::borrow(std::string_view key, std::string_view data, Section* parent) -> Entry
+{
+    Entry entry;
+    entry.m_key.emplace<std::string_view>(key);
+    entry.m_data.emplace<std::string_view>(data);
+    entry.m_parent = parent;
+    return entry;
+}
+
+/// \details Two Entries are equal if they have the same key, the same value and the same parent. It does not matter
+/// whether the text is owned or borrowed.
+inline auto Entry::operator==(const Entry& other) const -> bool
+{
+    return key() == other.key() and data() == other.data() and m_parent == other.m_parent;
+}
+
+/// \details Booleans are written as 1 and 0. Other arithmetic values are written with std::to_chars, which yields the
+/// shortest text that converts back to the same value and does not depend on the locale.
+/// \arg value The value to convert
+/// \returns The text representation of the value
+template<class T>
+auto Entry::toString(T value) -> std::string
+{
+    if constexpr (std::is_same_v<T, bool>) {
+        return value ? "1" : "0";
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        std::array<char, 64> buffer;
+        const auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        return {buffer.data(), end};
+    } else {
+        return std::to_string(value);
+    }
+}
+
+/// \details The conversion is done with std::from_chars and therefore does not depend on the locale and never throws.
+/// Surrounding whitespace and a leading + are ignored. Integers may be written in hexadecimal with a 0x prefix.
+/// Booleans accept true/false, yes/no and on/off in any case as well as integers, where everything except 0 is true.
+/// The whole text has to be consumed, so trailing characters are an error.
+/// \arg text The text to convert
+/// \arg value Receives the converted value. It is left unchanged if the conversion fails.
+/// \returns std::errc{} on success, std::errc::invalid_argument if the text is not a number of type T and
+/// std::errc::result_out_of_range if the number does not fit into T
+template<class T>
+auto Entry::fromString(std::string_view text, T& value) -> std::errc
+{
+    static_assert(std::is_arithmetic_v<T>, "Entry::value<T>() has to be specialized for types that are not arithmetic");
+
+    constexpr std::string_view whitespace = " \t\r\n";
+    text.remove_prefix(std::min(text.find_first_not_of(whitespace), text.size()));
+    text.remove_suffix(text.size() - (text.find_last_not_of(whitespace) + 1));
+
+    if constexpr (std::is_same_v<T, bool>) {
+        constexpr std::array<std::pair<std::string_view, bool>, 6> literals {{
+            {"true", true}, {"false", false}, {"yes", true}, {"no", false}, {"on", true}, {"off", false}
+        }};
+
+        for (const auto& [literal, result] : literals) {
+            if (std::equal(literal.begin(), literal.end(), text.begin(), text.end(), [](char lhs, char rhs) {
+                return lhs == (rhs >= 'A' and rhs <= 'Z' ? rhs - 'A' + 'a' : rhs);
+            })) {
+                value = result;
+                return {};
+            }
+        }
+
+        long long number;
+        const auto error = fromString(text, number);
+        if (error == std::errc{}) {
+            value = number != 0;
+        }
+
+        return error;
+    } else {
+        if (text.starts_with('+')) {
+            text.remove_prefix(1);
+            if (text.starts_with('-')) {
+                return std::errc::invalid_argument;
+            }
+        }
+
+        const auto end = text.data() + text.size();
+        std::from_chars_result result;
+
+        if constexpr (std::is_integral_v<T>) {
+            const auto hex = text.starts_with("0x") or text.starts_with("0X");
+            result = std::from_chars(text.data() + (hex ? 2 : 0), end, value, hex ? 16 : 10);
+        } else {
+            result = std::from_chars(text.data(), end, value);
+        }
+
+        if (result.ec == std::errc{} and result.ptr != end) {
+            return std::errc::invalid_argument;
+        }
+
+        return result.ec;
+    }
+}
+
 template<class T>
 constexpr Entry::Entry(std::string_view key, T value, Section* parent)
-    : m_key(key)
+    : m_key(std::string(key))
+    , m_data(toString(value))
     , m_parent(parent)
 {
-    m_data = std::to_string(value);
 }
 
 template<>
 inline Entry::Entry(std::string_view key, std::string value, Section* parent)
-    : m_key(key)
+    : m_key(std::string(key))
     , m_data(std::move(value))
     , m_parent(parent)
 {
@@ -83,7 +308,7 @@ inline Entry::Entry(std::string_view key, std::string value, Section* parent)
 
 template<>
 inline Entry::Entry(std::string_view key, std::string_view value, Section* parent)
-    : m_key(key)
+    : m_key(std::string(key))
     , m_data(std::string(value))
     , m_parent(parent)
 {
@@ -91,7 +316,7 @@ inline Entry::Entry(std::string_view key, std::string_view value, Section* paren
 
 template<>
 inline Entry::Entry(std::string_view key, const char* value, Section* parent)
-    : m_key(key)
+    : m_key(std::string(key))
     , m_data(std::string(value))
     , m_parent(parent)
 {
@@ -100,35 +325,80 @@ inline Entry::Entry(std::string_view key, const char* value, Section* parent)
 template<class T>
 auto Entry::setData(T value) -> void
 {
-    m_data = std::to_string(value);
+    m_data = toString(value);
+    m_cache.clear();
 }
 
 template<>
 inline auto Entry::setData(std::string value) -> void
 {
     m_data = std::move(value);
+    m_cache.clear();
 }
 
 template<>
 inline auto Entry::setData(std::string_view value) -> void
 {
-    m_data = value;
-}
-
-template<> inline auto Entry::value<bool>() const               -> bool               { return std::stoi(m_data); }
-template<> inline auto Entry::value<char>() const               -> char               { return std::stoi(m_data); }
-template<> inline auto Entry::value<short>() const              -> short              { return std::stoi(m_data); }
-template<> inline auto Entry::value<int>() const                -> int                { return std::stoi(m_data); }
-template<> inline auto Entry::value<long>() const               -> long               { return std::stol(m_data); }
-template<> inline auto Entry::value<long long>() const          -> long long          { return std::stoll(m_data); }
-template<> inline auto Entry::value<unsigned char>() const      -> unsigned char      { return std::stoull(m_data); }
-template<> inline auto Entry::value<unsigned short>() const     -> unsigned short     { return std::stoull(m_data); }
-template<> inline auto Entry::value<unsigned int>() const       -> unsigned int       { return std::stoull(m_data); }
-template<> inline auto Entry::value<unsigned long>() const      -> unsigned long      { return std::stoull(m_data); }
-template<> inline auto Entry::value<unsigned long long>() const -> unsigned long long { return std::stoull(m_data); }
-template<> inline auto Entry::value<float>() const              -> float              { return std::stof(m_data); }
-template<> inline auto Entry::value<double>() const             -> double             { return std::stod(m_data); }
-template<> inline auto Entry::value<long double>() const        -> long double        { return std::stold(m_data); }
-template<> inline auto Entry::value<std::string>() const        -> std::string        { return m_data; }
-template<> inline auto Entry::value<std::string_view>() const   -> std::string_view   { return m_data; }
+    m_data = std::string(value);
+    m_cache.clear();
+}
+
+template<>
+inline auto Entry::setData(const char* value) -> void
+{
+    m_data = std::string(value);
+    m_cache.clear();
+}
+
+/// \details Arithmetic types are converted with fromString(). Other types have to provide a specialization.
+/// \throws std::invalid_argument if the value is not a number of type T
+/// \throws std::out_of_range if the value does not fit into T
+/// \see tryValue for a conversion that does not throw
+template<class T>
+auto Entry::value() const -> T
+{
+    if (const auto cached = m_cache.load<T>()) {
+        return *cached;
+    }
+
+    T result{};
+    const auto error = fromString(data(), result);
+
+    if (error == std::errc::result_out_of_range) {
+        throw std::out_of_range{"Value of " + std::string(key()) + " is out of range: " + std::string(data())};
+    } else if (error != std::errc{}) {
+        throw std::invalid_argument{"Value of " + std::string(key()) + " is invalid: " + std::string(data())};
+    }
+
+    m_cache.store(result);
+    return result;
+}
+
+/// \details Arithmetic types are converted with fromString(). Strings always succeed.
+/// \returns The converted value or std::nullopt if the value cannot be converted to T
+template<class T>
+auto Entry::tryValue() const -> std::optional<T>
+{
+    if (const auto cached = m_cache.load<T>()) {
+        return cached;
+    }
+
+    T result{};
+
+    if (fromString(data(), result) != std::errc{}) {
+        return std::nullopt;
+    }
+
+    m_cache.store(result);
+    return result;
+}
+
+template<> inline auto Entry::value<std::string>() const        -> std::string        { return std::string(data()); }
+template<> inline auto Entry::value<std::string_view>() const   -> std::string_view   { return data(); }
+/// \note The returned pointer is only null terminated if the Entry owns its value. Prefer std::string_view for entries
+/// that were loaded with LoadMode::Mapped.
 template<> inline auto Entry::value<const char*>() const        -> const char*        { return data().data(); }
+
+template<> inline auto Entry::tryValue<std::string>() const      -> std::optional<std::string>      { return std::string(data()); }
+template<> inline auto Entry::tryValue<std::string_view>() const -> std::optional<std::string_view> { return data(); }
+template<> inline auto Entry::tryValue<const char*>() const      -> std::optional<const char*>      { return data().data(); }
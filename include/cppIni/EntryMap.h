@@ -0,0 +1,263 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cppIni/cppini_export.h>
+#include <cppIni/Entry.h>
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// \brief Map from keys to Entry objects with stable addresses
+/// \details The entries are stored in chunks allocated from the memory resource, so entries added one after another lie
+/// next to each other. A vector of pointers keeps the insertion order. Lookups use a compact open addressing table of
+/// 32-bit indices into that vector and 32-bit hash fragments, so a key is usually found with a single string comparison.
+/// \note An Entry keeps its address until it is removed or the map is destroyed. Moving the map keeps the addresses as
+/// well. Removing an Entry shifts the positions of the entries behind it, so iterators are invalidated by insertions and
+/// removals, while pointers and references to other entries stay valid. Every removal rebuilds the lookup table, so many
+/// entries are removed with a single erase_if() rather than one erase() each.
+/// \note The keys are not copied. They have to reference storage that outlives the map.
+class CPPINI_EXPORT EntryMap {
+public:
+    using value_type = std::pair<std::string_view, Entry>; ///< Key and Entry
+
+    /// \brief Random access iterator over the entries in insertion order
+    template<class Value>
+    class Iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag; ///< Iterator category
+        using value_type = std::remove_const_t<Value>; ///< Key and Entry
+        using difference_type = std::ptrdiff_t; ///< Distance between iterators
+        using pointer = Value*; ///< Pointer to key and Entry
+        using reference = Value&; ///< Reference to key and Entry
+
+        Iterator() = default; ///< Default constructor
+        explicit Iterator(EntryMap::value_type* const* position) : m_position(position) {} ///< Constructor with the position in the order of the map
+        template<class Other>
+        requires (std::is_same_v<const Other, Value> and not std::is_same_v<Other, Value>)
+        Iterator(const Iterator<Other>& other) : m_position(other.m_position) {} ///< Constant iterator from an iterator
+
+        auto operator*() const -> reference { return **m_position; } ///< Key and Entry
+        auto operator->() const -> pointer { return *m_position; } ///< Pointer to key and Entry
+        auto operator[](difference_type offset) const -> reference { return *m_position[offset]; } ///< Key and Entry at an offset
+
+        auto operator++() -> Iterator& { ++m_position; return *this; } ///< Pre-increment operator
+        auto operator++(int) -> Iterator { return Iterator{m_position++}; } ///< Post-increment operator
+        auto operator--() -> Iterator& { --m_position; return *this; } ///< Pre-decrement operator
+        auto operator--(int) -> Iterator { return Iterator{m_position--}; } ///< Post-decrement operator
+        auto operator+=(difference_type offset) -> Iterator& { m_position += offset; return *this; } ///< Advance by an offset
+        auto operator-=(difference_type offset) -> Iterator& { m_position -= offset; return *this; } ///< Go back by an offset
+
+        friend auto operator+(Iterator iterator, difference_type offset) -> Iterator { return iterator += offset; } ///< Iterator advanced by an offset
+        friend auto operator+(difference_type offset, Iterator iterator) -> Iterator { return iterator += offset; } ///< Iterator advanced by an offset
+        friend auto operator-(Iterator iterator, difference_type offset) -> Iterator { return iterator -= offset; } ///< Iterator moved back by an offset
+        friend auto operator-(const Iterator& lhs, const Iterator& rhs) -> difference_type { return lhs.m_position - rhs.m_position; } ///< Distance between iterators
+
+        auto operator==(const Iterator& other) const -> bool = default; ///< Equality operator
+        auto operator<=>(const Iterator& other) const -> std::strong_ordering = default; ///< Ordering of positions
+
+    private:
+        template<class Other>
+        friend class Iterator;
+
+        EntryMap::value_type* const* m_position{nullptr};
+    };
+
+    using iterator = Iterator<value_type>; ///< Iterator in insertion order
+    using const_iterator = Iterator<const value_type>; ///< Constant iterator in insertion order
+
+    explicit EntryMap(std::pmr::memory_resource* resource = std::pmr::get_default_resource()); ///< Constructor with the memory resource for the entries
+    EntryMap(const EntryMap& other); ///< Copy constructor
+    EntryMap(EntryMap&& other) noexcept; ///< Move constructor
+    ~EntryMap(); ///< Destructor
+
+    auto operator=(const EntryMap& other) -> EntryMap&; ///< Copy assignment operator
+    auto operator=(EntryMap&& other) noexcept -> EntryMap&; ///< Move assignment operator
+
+    auto begin() -> iterator { return iterator{m_order.data()}; } ///< Iterator to the first Entry
+    auto end() -> iterator { return iterator{m_order.data() + m_order.size()}; } ///< Iterator behind the last Entry
+    auto begin() const -> const_iterator { return const_iterator{m_order.data()}; } ///< Constant iterator to the first Entry
+    auto end() const -> const_iterator { return const_iterator{m_order.data() + m_order.size()}; } ///< Constant iterator behind the last Entry
+    auto cbegin() const -> const_iterator { return begin(); } ///< Constant iterator to the first Entry
+    auto cend() const -> const_iterator { return end(); } ///< Constant iterator behind the last Entry
+
+    auto size() const -> std::size_t { return m_order.size(); } ///< Number of entries
+    auto empty() const -> bool { return m_order.empty(); } ///< Whether the map has no entries
+
+    auto find(std::string_view key) -> iterator; ///< Find an Entry by key
+    auto find(std::string_view key) const -> const_iterator; ///< Find an Entry by key
+    auto get(std::string_view key) -> Entry*; ///< Entry with the key, nullptr if it does not exist
+    auto get(std::string_view key) const -> const Entry*; ///< Entry with the key, nullptr if it does not exist
+    auto contains(std::string_view key) const -> bool { return get(key) != nullptr; } ///< Whether an Entry with the key exists
+    auto at(std::string_view key) -> Entry&; ///< Entry with the key. Throws if it does not exist.
+    auto at(std::string_view key) const -> const Entry&; ///< Entry with the key. Throws if it does not exist.
+
+    template<class... Args>
+    auto try_emplace(std::string_view key, Args&&... args) -> std::pair<iterator, bool>; ///< Insert an Entry unless the key exists
+    template<class E>
+    auto insert_or_assign(std::string_view key, E&& entry) -> std::pair<iterator, bool>; ///< Insert or replace an Entry
+    auto erase(std::string_view key) -> std::size_t; ///< Remove the Entry with the key if it exists
+    template<class Predicate>
+    auto erase_if(Predicate predicate) -> std::size_t; ///< Remove all entries the predicate is true for at once
+    auto reserve(std::size_t size) -> void; ///< Make room for entries without allocating again
+    auto swap(EntryMap& other) noexcept -> void; ///< Exchange the entries and the memory resources of two maps
+
+private:
+    /// \brief Allocator from a memory resource that moves with its container, unlike std::pmr::polymorphic_allocator,
+    /// so a moved map keeps its memory resource and none of its storage is copied
+    template<class T>
+    class Allocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        Allocator(std::pmr::memory_resource* resource) noexcept : m_resource(resource) {}
+        template<class U>
+        Allocator(const Allocator<U>& other) noexcept : m_resource(other.resource()) {}
+
+        auto allocate(std::size_t size) -> T* { return static_cast<T*>(m_resource->allocate(size * sizeof(T), alignof(T))); }
+        auto deallocate(T* data, std::size_t size) noexcept -> void { m_resource->deallocate(data, size * sizeof(T), alignof(T)); }
+        auto resource() const noexcept -> std::pmr::memory_resource* { return m_resource; }
+
+        template<class U>
+        auto operator==(const Allocator<U>& other) const noexcept -> bool { return *m_resource == *other.resource(); }
+
+    private:
+        std::pmr::memory_resource* m_resource;
+    };
+
+    template<class T>
+    using Vector = std::vector<T, Allocator<T>>;
+
+    /// \brief Position in the lookup table
+    struct Slot {
+        std::uint32_t hash; ///< Upper half of the hash of the key
+        std::uint32_t index; ///< Index of the Entry in m_order plus one, 0 if the slot is empty
+    };
+
+    /// \brief Block of storage for entries
+    struct Chunk {
+        value_type* data; ///< Storage for capacity entries
+        std::size_t capacity; ///< Number of entries that fit into the chunk
+        std::size_t used; ///< Number of entries handed out from the front of the chunk
+    };
+
+    auto resource() const -> std::pmr::memory_resource* { return m_order.get_allocator().resource(); } ///< Memory resource of the entries
+    auto allocate() -> value_type*; ///< Storage for one Entry
+    auto deallocate(value_type* storage) noexcept -> void; ///< Give back storage returned by the last allocate()
+    auto grow(std::size_t capacity) -> void; ///< Append a chunk and make the rest of the previous one available
+    auto release() noexcept -> void; ///< Destroy all entries and free all chunks
+    auto prepare(std::string_view key) -> std::pair<std::size_t, std::size_t>; ///< Slot and hash for inserting the key
+    auto probe(std::string_view key, std::size_t hash) const -> std::size_t; ///< Slot of the key or the empty slot where it belongs
+    auto rehash(std::size_t slots) -> void; ///< Rebuild the lookup table with the given number of slots
+    static auto fragment(std::size_t hash) -> std::uint32_t; ///< Part of the hash stored in a Slot
+
+    Vector<value_type*> m_order; ///< The entries in insertion order
+    Vector<Slot> m_slots;
+    Vector<Chunk> m_chunks;
+    Vector<value_type*> m_free; ///< Storage of removed entries and the unused rest of earlier chunks
+};
+
+/// \details The Entry is constructed from the arguments and appended behind all other entries. Nothing is constructed or
+/// moved if the key exists.
+/// \param key The key of the Entry. It has to reference storage that outlives the map.
+/// \param args The arguments passed to the constructor of Entry.
+/// \returns An iterator to the inserted or existing Entry and whether the Entry was inserted.
+template<class... Args>
+auto EntryMap::try_emplace(std::string_view key, Args&&... args) -> std::pair<iterator, bool>
+{
+    const auto [position, hash] = prepare(key);
+    auto& slot = m_slots[position];
+
+    if (slot.index != 0) {
+        return {begin() + (slot.index - 1), false};
+    }
+
+    m_order.reserve(m_order.size() + 1);
+    const auto storage = allocate();
+
+    try {
+        m_order.push_back(std::construct_at(storage, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)));
+    } catch (...) {
+        deallocate(storage);
+        throw;
+    }
+
+    slot = {fragment(hash), static_cast<std::uint32_t>(m_order.size())};
+
+    return {end() - 1, true};
+}
+
+/// \param key The key of the Entry. It has to reference storage that outlives the map.
+/// \param entry The Entry to insert or assign.
+/// \returns An iterator to the Entry and whether the Entry was inserted.
+template<class E>
+auto EntryMap::insert_or_assign(std::string_view key, E&& entry) -> std::pair<iterator, bool>
+{
+    auto result = try_emplace(key, std::forward<E>(entry));
+
+    if (not result.second) {
+        result.first->second = std::forward<E>(entry);
+    }
+
+    return result;
+}
+
+/// \details The entries are removed in a single pass and the lookup table is rebuilt once, so removing many entries costs
+/// about as much as removing one. The remaining entries keep their order and their address.
+/// \param predicate Called with the key and the Entry of every Entry, returns whether it is removed. It must not throw.
+/// \returns The number of removed entries.
+template<class Predicate>
+auto EntryMap::erase_if(Predicate predicate) -> std::size_t
+{
+    auto kept = m_order.begin();
+
+    for (auto position = m_order.begin(); position != m_order.end(); ++position) {
+        if (not predicate(std::as_const(**position))) {
+            std::iter_swap(kept++, position);
+        }
+    }
+
+    const auto removed = static_cast<std::size_t>(m_order.end() - kept);
+
+    if (removed != 0) {
+        m_free.reserve(m_free.size() + removed);
+
+        for (auto position = kept; position != m_order.end(); ++position) {
+            std::destroy_at(*position);
+            m_free.push_back(*position);
+        }
+
+        m_order.erase(kept, m_order.end());
+        rehash(m_slots.size());
+    }
+
+    return removed;
+}
@@ -19,49 +19,437 @@
 #pragma once
 
 #include <cppIni/cppini_export.h>
+#include <cppIni/FrozenFile.h>
+#include <cppIni/Parser.h>
 #include <cppIni/Section.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
 #include <vector>
 #include <format>
 
+#ifndef CPPINI_STATISTICS
+#define CPPINI_STATISTICS 1 ///< Whether Files count what they do, see File::stats(). Set by the build.
+#endif
+
+class FileWatcher;
+class KeyHandle;
+class MappedFile;
+class SectionHandle;
+
+/// \brief Selects how a File reads its content from disk.
+enum class LoadMode {
+    Stream, ///< Read the file line by line and copy every key and value into its Entry.
+    Mapped, ///< Map the whole file into memory and keep keys and values as views into the mapping.
+    Lazy, ///< Like Mapped, but the entries of a Section are only parsed when the Section is first looked up.
+};
+
+/// \brief Selects how a File writes its changes to disk.
+enum class FlushMode {
+    InPlace, ///< Write only the changes into the existing file. A crash during a flush may leave the file partially written.
+    Atomic, ///< Write the whole file to a temporary file, synchronize it to disk and rename it over the original.
+};
+
+/// \brief Options that control how a File is opened.
+struct OpenOptions {
+    LoadMode loadMode {LoadMode::Stream}; ///< How the file is read from disk.
+    FlushMode flushMode {FlushMode::InPlace}; ///< How changes are written to disk.
+    std::shared_ptr<StringPool> stringPool {}; ///< Pool shared with other Files for titles, keys and short values.
+    bool autoFlush {true}; ///< Whether every change is written to disk immediately.
+    bool arena {false}; ///< Whether sections, entries and strings are allocated from a single arena owned by the File.
+    bool cache {false}; ///< Whether the File is loaded from and stored to a binary cache next to the file on disk.
+    bool threadSafe {false}; ///< Whether the File may be read and changed from several threads at the same time.
+    bool watch {false}; ///< Whether the file system notifies the File about changes to the file, see File::poll(). Sections removed by reloads are kept until File::compact().
+    unsigned parseThreads {1}; ///< Number of threads that parse a file opened with LoadMode::Mapped, 0 for one per core.
+};
+
+/// \brief Counters that describe the work done by a File and the memory it holds, see File::stats().
+/// \details sections, entries and heapBytes describe the current state of the File, all other counters are summed up
+/// since it was opened. Lookups are counted by findEntry(), get() and tryGet(), not by handles, which do not look
+/// anything up. The struct only holds plain values, so it can be copied into any metrics system.
+struct FileStats {
+    std::uint64_t bytesParsed {0}; ///< Bytes of text read by opening and reloading the file
+    std::uint64_t lines {0}; ///< Lines of text read by opening and reloading the file, including empty ones
+    std::uint64_t sections {0}; ///< Current number of Sections
+    std::uint64_t entries {0}; ///< Current number of entries, without the ones of lazily loaded Sections that were not parsed yet
+    std::uint64_t loads {0}; ///< Number of times the file was read, from text or from its binary cache
+    std::chrono::nanoseconds loadTime {0}; ///< Total wall time spent reading the file
+    std::uint64_t flushes {0}; ///< Number of flushes
+    std::uint64_t autoFlushes {0}; ///< Flushes triggered by set(), setMany() or Batch::commit() because auto flush is enabled
+    std::chrono::nanoseconds flushTime {0}; ///< Total wall time spent in flush()
+    std::uint64_t hits {0}; ///< Lookups that found their Entry
+    std::uint64_t misses {0}; ///< Lookups that did not find their Entry
+    std::uint64_t heapBytes {0}; ///< Approximate heap memory held by the File, without mappings of the file or its cache
+};
+
 /// \brief Represents a file on disk.
 /// A file is a collection of Sections.
+/// \details The File remembers where every Section and Entry is located on disk. flush() only replaces the values that
+/// were changed and inserts new entries and sections, so the layout of the file is kept and the cost of a flush depends
+/// on the size of the change rather than the size of the file.
+/// \note With OpenOptions::cache, the parsed file is stored in a binary image next to it (e.g. "config.ini.cache").
+/// While the file does not change, it is loaded by mapping that image instead of being parsed.
+/// \note With OpenOptions::threadSafe, get(), tryGet(), findSection(), findEntry(), set(), setMany(), batches, flush(),
+/// freeze() and writeCache() may be called from several threads at the same time. Readers only take shared locks.
+/// Writers lock the Section they change, so changes to different Sections do not wait for each other. Pointers
+/// returned by findEntry() and views returned by get() are only valid until another thread changes their Section,
+/// and Sections returned by getSection() and iterated with sections() are not synchronized.
+/// \note reload() and poll() update the File to the content of the file on disk. Sections and entries that did not
+/// change keep their address, so pointers to them stay valid. With OpenOptions::watch, poll() only looks at the file
+/// after the file system reported a change. Sections removed by a reload are kept alive for pointers that may still
+/// refer to them, so a File that is reloaded again and again grows until compact() destroys them.
+/// \note With LoadMode::Lazy, opening the file only finds the titles and creates the Sections. The entries of a Section
+/// are parsed by the first findSection(), findEntry(), get(), tryGet() or getSection() that reaches it. sections() and
+/// everything else that visits all Sections, like freeze(), writeCache(), reload() or a flush that writes the whole file,
+/// parses all remaining Sections first.
+/// \note fromBuffer(), fromString() and fromStream() read a File from memory instead of a file. Keys and values are
+/// borrowed from the text, which must outlive the File unless the File owns it. Such a File has no file on disk, so
+/// flush() only forgets the changes, reload() and poll() do nothing and the cache and watch options are ignored.
+/// \note stats() reports what the File did and how much memory it holds. The counters are relaxed atomics that are only
+/// updated if the library was built with CPPINI_STATISTICS, which is the default.
+/// \note Keys that are read over and over can be resolved once with keyHandle(). The returned KeyHandle reads its Entry
+/// without looking up any names until the next reload.
+/// \note A File can be moved but not copied. Moving it moves the ownership of its Sections, which stay where they are,
+/// so pointers to Sections and entries stay valid. Handles and Batches refer to the File itself and have to be
+/// created again for the File moved to.
 class CPPINI_EXPORT File {
 public:
-    explicit File(std::string_view filename); ///< Constructor.
-    virtual ~File(); ///< Destructor.
+    class Batch;
+
+    explicit File(std::string_view filename, OpenOptions options = {}); ///< Constructor.
+    File(const File&) = delete; ///< Files are not copyable, use freeze() for a snapshot.
+    File(File&& other) noexcept; ///< Move constructor.
+    ~File(); ///< Destructor.
+
+    auto operator=(const File&) -> File& = delete; ///< Files are not copyable, use freeze() for a snapshot.
+    auto operator=(File&& other) noexcept -> File&; ///< Move assignment operator.
 
-    static File open(std::string_view filename); ///< Open a file. Throws if the file cannot be opened.
-    void open(); ///< Open the file. Throws if the file cannot be opened.
-    void flush(); ///< Write the file to disk.
+    static File open(std::string_view filename, OpenOptions options = {}); ///< Open a file. Throws if the file cannot be opened.
+    static auto fromBuffer(std::string_view content, OpenOptions options = {}) -> File; ///< Parse text that outlives the File without copying it.
+    static auto fromBuffer(std::span<const char> content, OpenOptions options = {}) -> File; ///< Parse bytes that outlive the File without copying them.
+    static auto fromString(std::string content, OpenOptions options = {}) -> File; ///< Parse text the File takes ownership of.
+    static auto fromStream(std::istream& input, OpenOptions options = {}) -> File; ///< Parse the rest of a stream.
+    void open(); ///< Open the file. Throws if the file cannot be opened. Reloads the file if it was opened before.
+    auto reload() -> void; ///< Read the file again and update only the Sections and entries that changed.
+    auto poll() -> bool; ///< Reload the file if it was changed on disk. Does not block.
+    auto compact() -> std::size_t; ///< Destroy the Sections removed by reloads. Invalidates pointers to them and their entries.
+    auto watchHandle() const -> int; ///< Descriptor that becomes readable when the file changes, -1 if it is not watched.
+    void flush(); ///< Write the changes to disk.
+    auto writeCache() const -> void; ///< Write the binary cache of the file, which is loaded instead of parsing it while the file does not change.
 
     template<class T>
     auto set(std::string_view section, std::string_view key, T value) -> void; ///< Set a value in a section.
+    template<std::ranges::input_range R>
+    auto setMany(R&& changes) -> void; ///< Set a range of (section, key, value) tuples and write the file once.
+    auto batch() -> Batch; ///< Collect changes that are applied and written at once.
 
-    auto getSection(std::string_view fqTitle) -> Section*; ///< Get a Section by fully qualified title (e.g. "Section1.Section2")
+    auto autoFlush() const -> bool { return m_options.autoFlush; } ///< Whether every change is written to disk immediately.
+    auto setAutoFlush(bool autoFlush) -> void { m_options.autoFlush = autoFlush; } ///< Enable or disable writing every change immediately.
+
+    auto getSection(std::string_view fqTitle) -> Section*; ///< Get a Section by fully qualified title (e.g. "Section1.Section2"). The next flush rewrites the whole file.
     auto findSection(std::string_view title) const -> const Section*; ///< Find a Section by title.
     auto findEntry(std::string_view name) const -> const Entry*; ///< Find an Entry by name.
+    auto findEntry(std::string_view section, std::string_view name) const -> const Entry*; ///< Find an Entry by section and name.
 
     template<class T>
     auto get(std::string_view section, std::string_view name) const -> T; ///< Get an Entry by name and convert it to the specified type.
+    template<class T>
+    auto tryGet(std::string_view section, std::string_view name) const -> std::optional<T>; ///< Get an Entry by name and convert it without throwing.
+
+    auto sectionHandle(std::string_view fqTitle) const -> SectionHandle; ///< Resolve a Section once for repeated access.
+    auto keyHandle(std::string_view section, std::string_view key) const -> KeyHandle; ///< Resolve an Entry once for repeated access.
 
-    constexpr auto sections() const -> const auto& { return m_sections; }
+    auto sections() const -> const std::vector<Section*>&; ///< All Sections in the order of the file.
+    auto stringPool() const -> const std::shared_ptr<StringPool>& { return m_pool; } ///< Pool storing titles and keys.
+
+    auto freeze() const -> FrozenFile; ///< Immutable snapshot with constant time lookups that can be shared across threads.
+    auto stats() const -> FileStats; ///< Counters that describe the work done by the File and the memory it holds.
+
+    static constexpr bool statisticsEnabled = CPPINI_STATISTICS != 0; ///< Whether stats() counts anything
 
     auto operator==(const File& other) const -> bool; ///< Equality operator.
     auto operator!=(const File& other) const -> bool { return !(*this == other); }; ///< Inequality operator.
 
 private:
+    struct Patch;
+    struct Locks;
+    struct Reader;
+    struct Unopened {}; ///< Selects the constructor that does not read anything
+
+    /// \brief Counters of stats() that are updated while the File is used
+    struct Counters {
+        Counters() = default;
+        Counters(const Counters& other) noexcept; ///< Copy of the current values, used when a File is moved
+        auto operator=(const Counters& other) noexcept -> Counters&; ///< Copy the current values, used when a File is moved
+
+        std::atomic<std::uint64_t> bytesParsed{0};
+        std::atomic<std::uint64_t> lines{0};
+        std::atomic<std::uint64_t> loads{0};
+        std::atomic<std::uint64_t> loadTime{0}; ///< Nanoseconds
+        std::atomic<std::uint64_t> flushes{0};
+        std::atomic<std::uint64_t> autoFlushes{0};
+        std::atomic<std::uint64_t> flushTime{0}; ///< Nanoseconds
+        std::atomic<std::uint64_t> hits{0}; ///< Only used if the File is not thread-safe, see Locks
+        std::atomic<std::uint64_t> misses{0}; ///< Only used if the File is not thread-safe, see Locks
+    };
+
+    /// \brief Destroys a Section without releasing its memory, which belongs to m_sectionStorage
+    struct DestroySection {
+        auto operator()(Section* section) const noexcept -> void { std::destroy_at(section); }
+    };
+
+    template<class T, class... Fields>
+    friend class Schema;
+    friend class KeyHandle;
+    friend class SectionHandle;
+
+    File(std::string_view filename, OpenOptions options, Unopened); ///< Constructor that only sets up the members.
+    File(std::string_view content, std::shared_ptr<const std::string> owner, OpenOptions options); ///< Constructor for text in memory.
+
     void parse(); ///< Parse the file.
+    auto parseBuffer(std::string_view content) -> void; ///< Parse text in memory whose keys and values are borrowed.
+    auto finishParse(std::size_t size, bool newline) -> void; ///< Remember the size and the end of the parsed text.
+    auto loadCache() -> bool; ///< Load the file from its binary cache if it is valid.
+    auto merge(const File& fresh) -> void; ///< Take over what changed in another File read from the same file.
+    auto changedOnDisk() const -> bool; ///< Whether the size or the write time of the file changed since it was last read or written.
+    void parseSection(const ParsedSection& parsed); ///< Create the Section of a title line.
+    void parseEntry(Section& section, const ParsedEntry& parsed, bool borrow); ///< Add the Entry of a line to the Section.
+    void parseChunks(std::string_view content, std::size_t threads); ///< Parse mapped content on several threads.
+    auto load(Section& section) -> void; ///< Parse the entries of a lazily loaded Section if that did not happen yet.
+    auto loadAll() -> void; ///< Parse the entries of all lazily loaded Sections. Requires the exclusive lock of the Sections.
+    auto loadLocked(const Section* section) const -> void; ///< load() with the locks of a thread-safe File.
+    auto addSection(std::string_view title, Section* parent) -> Section*; ///< Append a new Section and index it.
+    auto makeSection(std::string_view fqTitle) -> Section*; ///< Find or create a Section without giving up change tracking.
+    auto insertSection(std::string_view fqTitle) -> Section*; ///< Find or create a Section and its parents. Requires the exclusive lock of the Sections.
+    auto lockShared(const Section* section) const -> std::shared_lock<std::shared_mutex>; ///< Shared lock of the entries of the Section, empty if the File is not thread-safe.
+    auto apply(std::string_view section, Entry entry) -> void; ///< Set an Entry and remember it for the next flush.
+    auto write() -> void; ///< Write the whole file.
+    auto copy(std::string_view text) -> std::string_view; ///< Copy text into the arena.
+    auto patch() -> void; ///< Write only the changes since the last flush.
+    auto countLookup(const Section* section, bool found) const -> void; ///< Count a hit or a miss of a lookup.
+    static auto count(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1) -> void; ///< Add to a counter of stats().
 
 private:
     std::string m_filename{};
+    OpenOptions m_options{};
+    std::shared_ptr<std::pmr::monotonic_buffer_resource> m_arena{}; ///< Storage for everything in the File if OpenOptions::arena is set
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> m_sectionStorage{}; ///< Keeps the Section objects next to each other and reuses the memory of destroyed ones
+
+    std::shared_ptr<StringPool> m_pool{}; ///< Either the shared pool from the options or a private one
+    std::vector<std::unique_ptr<Section, DestroySection>> m_storage{}; ///< Owns every Section, also those removed by a reload, which may still be referenced
+    std::vector<Section*> m_sections{}; ///< The Sections in the order of the file
+    std::pmr::unordered_map<std::string_view, Section*> m_index{}; ///< Sections by fully qualified title
+    std::shared_ptr<const MappedFile> m_mapping{}; ///< Storage borrowed by the entries in LoadMode::Mapped
+    std::shared_ptr<const MappedFile> m_image{}; ///< Binary cache borrowed by the entries if the file was loaded from it
+    std::shared_ptr<const std::string> m_buffer{}; ///< Text borrowed by the entries if the File was read from memory it owns
+    std::unique_ptr<Locks> m_locks{}; ///< Only exists if OpenOptions::threadSafe is set
+    std::unique_ptr<FileWatcher> m_watcher{}; ///< Only exists if OpenOptions::watch is set
 
-    std::vector<Section*> m_sections{};
+    std::vector<std::pair<Section*, std::size_t>> m_changed{}; ///< Sections and indices of the entries set since the last flush
+    std::size_t m_writtenSections{0}; ///< Number of Sections that exist in the file on disk
+    std::atomic<std::size_t> m_unparsed{0}; ///< Number of Sections whose entries were not parsed yet with LoadMode::Lazy
+    std::atomic<std::uint64_t> m_generation{0}; ///< Incremented by every reload, which may erase entries and detach Sections
+    mutable Counters m_counters{};
+    std::uintmax_t m_fileSize{0}; ///< Size of the file on disk as last read or written
+    std::filesystem::file_time_type m_fileTime{}; ///< Write time of the file on disk as last read or written
+    bool m_endsWithNewline{true}; ///< Whether the file on disk ends with a line break
+    bool m_patchable{true}; ///< Whether all changes since the last flush are known
+    bool m_borrowing{true}; ///< Whether no Entry owns its text, so the arena can be released without destroying them
 };
 
-/// \details Calls findEntry() and returns the value of the Entry if it exists.
-/// Otherwise, returns a default-constructed value.
+/// \brief Collects changes to a File and applies them at once
+/// \details Changes are staged with set() and applied to the File by commit(), which writes the File only once.
+/// Changes that have not been committed when the Batch is destroyed are discarded.
+/// \code
+/// auto batch = file.batch();
+/// batch.set("Section", "Key1", 42).set("Section", "Key2", "Value");
+/// batch.commit();
+/// \endcode
+class File::Batch {
+public:
+    explicit Batch(File& file) : m_file(file) {} ///< Constructor with the File to change.
+
+    template<class T>
+    auto set(std::string_view section, std::string_view key, T value) -> Batch&; ///< Stage a value.
+    auto commit() -> void; ///< Apply all staged values and write the file once.
+
+    auto size() const -> std::size_t { return m_changes.size(); } ///< Number of staged values.
+
+private:
+    File& m_file;
+    std::vector<std::pair<std::string, Entry>> m_changes{};
+};
+
+inline auto File::batch() -> Batch
+{
+    return Batch{*this};
+}
+
+/// \details Relaxed, because the counters are only read by stats(), which does not need to be exact while the File is
+/// used. Does nothing if the library was built without CPPINI_STATISTICS.
+/// \arg counter The counter to change
+/// \arg amount The amount to add
+inline auto File::count(std::atomic<std::uint64_t>& counter, std::uint64_t amount) -> void
+{
+    if constexpr (statisticsEnabled) {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+/// \arg section The title of the Section to set the value in.
+/// \arg key The key of the Entry to set.
+/// \arg value The value of the Entry to set.
+/// \returns This Batch to chain further calls.
+template<class T>
+auto File::Batch::set(std::string_view section, std::string_view key, T value) -> Batch&
+{
+    m_changes.emplace_back(section, Entry{key, value});
+    return *this;
+}
+
+/// \details The staged values are applied in the order they were set. The File is written once if auto flush is
+/// enabled. Afterwards the Batch is empty and can be reused.
+inline auto File::Batch::commit() -> void
+{
+    for (auto& [section, entry] : m_changes) {
+        m_file.apply(section, std::move(entry));
+    }
+
+    m_changes.clear();
+
+    if (m_file.autoFlush()) {
+        count(m_file.m_counters.autoFlushes);
+        m_file.flush();
+    }
+}
+
+/// \brief Resolved Section of a File that is found without looking up its title again
+/// \details A SectionHandle is created by File::sectionHandle(). It remembers the Section it found until the File is
+/// reloaded, which may detach Sections, and looks the title up once more afterwards. A handle to a Section that does not
+/// exist looks it up on every access, so it finds the Section once it is created.
+/// \note A handle stays valid as long as its File exists. It remembers what it found, so one handle must not be used by
+/// several threads at the same time. Copies are cheap and independent.
+class CPPINI_EXPORT SectionHandle {
+public:
+    SectionHandle() = default; ///< Handle that refers to no Section
+
+    auto get() const -> const Section*; ///< The Section, nullptr if it does not exist.
+    auto exists() const -> bool { return get() != nullptr; } ///< Whether the Section exists. False after it was removed.
+    auto title() const -> std::string_view { return m_title; } ///< Fully qualified title of the Section
+
+    auto key(std::string_view key) const -> KeyHandle; ///< Resolve an Entry of the Section once for repeated access.
+
+private:
+    friend class File;
+    friend class KeyHandle;
+
+    SectionHandle(const File* file, std::string_view title) : m_file{file}, m_title{title} {} ///< Constructor with the interned title
+    auto current() const -> bool; ///< Whether the File was not reloaded since the Section was found
+
+    const File* m_file{nullptr};
+    std::string_view m_title{}; ///< Interned in the pool of the File
+    mutable const Section* m_section{nullptr};
+    mutable std::uint64_t m_generation{0}; ///< File::m_generation when m_section was found
+};
+
+/// \brief Resolved Entry of a File that is read without looking up its names again
+/// \details A KeyHandle is created by File::keyHandle() or SectionHandle::key(). It remembers the Section and the
+/// position of the Entry in it. Setting values only appends entries, so the position stays valid across set() and
+/// flush(), and a read only checks that the File was not reloaded and takes the lock of the Section in a thread-safe
+/// File. A reload may erase entries, so afterwards the handle looks up the Section and the key once more. A key that
+/// does not exist is looked up on every read, so the handle finds it once it is set and reports when it was removed.
+/// \note A handle stays valid as long as its File exists. It remembers what it found, so one handle must not be used by
+/// several threads at the same time. Copies are cheap and independent.
+/// \code
+/// const auto port = file.keyHandle("Server.Http", "Port");
+/// while (serving) {
+///     accept(port.get<int>());
+/// }
+/// \endcode
+class CPPINI_EXPORT KeyHandle {
+public:
+    KeyHandle() = default; ///< Handle that refers to no Entry
+
+    auto entry() const -> const Entry*; ///< The Entry, nullptr if the key does not exist.
+    auto exists() const -> bool { return entry() != nullptr; } ///< Whether the key exists. False after it was removed.
+
+    template<class T>
+    auto get() const -> T; ///< Convert the value of the Entry to the specified type.
+    template<class T>
+    auto tryGet() const -> std::optional<T>; ///< Convert the value of the Entry without throwing.
+
+    auto section() const -> const SectionHandle& { return m_section; } ///< Handle of the Section of the Entry
+    auto key() const -> std::string_view { return m_key; } ///< Key of the Entry
+
+private:
+    friend class File;
+    friend class SectionHandle;
+
+    KeyHandle(SectionHandle section, std::string_view key) : m_section{section}, m_key{key} {} ///< Constructor with the interned key
+
+    template<class F>
+    auto visit(F&& function) const -> decltype(function(nullptr)); ///< Call the function with the Entry while its Section is locked
+    auto locate(const Section& section) const -> const Entry*; ///< The Entry in the Section. Requires the lock of the Section.
+
+    SectionHandle m_section{};
+    std::string_view m_key{}; ///< Interned in the pool of the File
+    mutable std::size_t m_index{std::string_view::npos}; ///< Position of the Entry in its Section
+    mutable std::uint64_t m_generation{0}; ///< SectionHandle::m_generation when m_index was found
+};
+
+/// \details The generation of the File is compared while the Section is locked. A reload increments it before it
+/// changes any Section, so an unchanged generation guarantees that the remembered position is still the Entry.
+/// \arg function Called with the Entry or nullptr if it does not exist.
+/// \returns The result of the function.
+template<class F>
+auto KeyHandle::visit(F&& function) const -> decltype(function(nullptr))
+{
+    while (const auto section = m_section.get()) {
+        const auto lock = m_section.m_file->lockShared(section);
+
+        // A reload between finding the Section and locking it may have moved the entries
+        if (m_section.current()) {
+            return function(locate(*section));
+        }
+    }
+
+    return function(nullptr);
+}
+
+/// \details Neither the title nor the key is hashed unless the File was reloaded or the key did not exist yet. In a
+/// thread-safe File, the value is converted while the Section is locked.
+/// \tparam T The type of the value to return.
+/// \returns The value of the Entry if it exists, otherwise a default-constructed value.
+template<class T>
+auto KeyHandle::get() const -> T
+{
+    return visit([](const Entry* entry) -> T {
+        return entry ? entry->value<T>() : T();
+    });
+}
+
+/// \details Finds the Entry like get() and converts its value with Entry::tryValue().
+/// \tparam T The type of the value to return.
+/// \returns The value of the Entry, or std::nullopt if it does not exist or cannot be converted.
+template<class T>
+auto KeyHandle::tryGet() const -> std::optional<T>
+{
+    return visit([](const Entry* entry) -> std::optional<T> {
+        return entry ? entry->tryValue<T>() : std::nullopt;
+    });
+}
+
+/// \details Looks up the Entry like findEntry() and returns its value if it exists.
+/// Otherwise, returns a default-constructed value. The lookup itself does not allocate. In a thread-safe File, the
+/// value is converted while the Section is locked.
 /// \arg section The fully qualified title of the Section to search in.
 /// \arg name The name of the Entry to search for.
 /// \tparam T The type of the value to return.
@@ -69,28 +457,78 @@ private:
 template<class T>
 auto File::get(std::string_view section, std::string_view name) const -> T
 {
-    if (const auto entry = findEntry(std::format("{}.{}", section, name))) {
-        return entry->value<T>();
+    if (const auto s = findSection(section)) {
+        const auto lock = lockShared(s);
+
+        const auto entry = s->findEntry(name);
+        countLookup(s, entry != nullptr);
+
+        if (entry) {
+            return entry->value<T>();
+        }
+
+        return T();
     }
 
+    countLookup(nullptr, false);
     return T();
 }
 
-/// \details The parameters are forwarded to the Section::setEntry() method. The Section is created if it does not exist.
+/// \details Looks up the Entry like findEntry() and converts its value with Entry::tryValue(). In a thread-safe File, the
+/// value is converted while the Section is locked.
+/// \arg section The fully qualified title of the Section to search in.
+/// \arg name The name of the Entry to search for.
+/// \tparam T The type of the value to return.
+/// \returns The value of the Entry, or std::nullopt if it does not exist or cannot be converted.
+template<class T>
+auto File::tryGet(std::string_view section, std::string_view name) const -> std::optional<T>
+{
+    if (const auto s = findSection(section)) {
+        const auto lock = lockShared(s);
+
+        const auto entry = s->findEntry(name);
+        countLookup(s, entry != nullptr);
+
+        if (entry) {
+            return entry->tryValue<T>();
+        }
+
+        return std::nullopt;
+    }
+
+    countLookup(nullptr, false);
+    return std::nullopt;
+}
+
+/// \details The Section and the Entry are created if they do not exist. The file is written afterwards if auto flush is
+/// enabled.
 /// \arg section The title of the Section to set the value in.
 /// \arg key The key of the Entry to set.
 /// \arg value The value of the Entry to set.
 template<class T>
 auto File::set(std::string_view section, std::string_view key, T value) -> void
 {
-    if (auto s = std::ranges::find_if(m_sections,
-                                      [section](const auto& s) { return s->fqTitle() == section; });
-            s != m_sections.end()) {
-        (*s)->setEntry({key, value});
-    } else {
-        auto targetSection = getSection(section);
-        targetSection->setEntry({key, value});
+    apply(section, Entry{key, value});
+
+    if (m_options.autoFlush) {
+        count(m_counters.autoFlushes);
+        flush();
     }
+}
 
-    flush();
+/// \details Every element of the range is a tuple-like object of section, key and value (e.g. a std::tuple or an
+/// aggregate with three members). All values are set in memory first and the file is written once afterwards if auto
+/// flush is enabled.
+/// \arg changes The range of (section, key, value) tuples to set.
+template<std::ranges::input_range R>
+auto File::setMany(R&& changes) -> void
+{
+    for (const auto& [section, key, value] : changes) {
+        apply(section, Entry{key, value});
+    }
+
+    if (m_options.autoFlush) {
+        count(m_counters.autoFlushes);
+        flush();
+    }
 }
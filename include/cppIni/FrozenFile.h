@@ -0,0 +1,229 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cppIni/cppini_export.h>
+#include <cppIni/Entry.h>
+#include <cppIni/Section.h>
+#include <cppIni/StringPool.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+class File;
+
+/// \brief Immutable snapshot of a File with constant time lookups
+/// \details A FrozenFile copies all Sections and Entries of a File into storage it owns and indexes them with minimal
+/// perfect hashes: one over the fully qualified titles of the Sections and one over the (Section, key) pairs of the
+/// Entries. A lookup hashes the names once, reads the slot chosen by the hash and compares the names stored in it, so
+/// it neither probes nor follows pointers through the Sections.
+/// \note A FrozenFile cannot be changed and does not depend on the File it was created from. All its member functions
+/// are const and do not modify shared state except the thread-safe value cache of the entries, so a FrozenFile can be
+/// read from several threads at the same time without locking.
+/// \note If a File contains several Sections with the same fully qualified title, lookups find the first one, like
+/// File::findSection() does. All of them are kept in sections().
+/// \code
+/// const auto frozen = file.freeze();
+/// const auto port = frozen.get<int>("Server.Http", "Port");
+/// \endcode
+class CPPINI_EXPORT FrozenFile {
+public:
+    explicit FrozenFile(const File& file); ///< Constructor with the File to copy
+
+    FrozenFile(FrozenFile&&) noexcept = default; ///< Move constructor
+    auto operator=(FrozenFile&& other) noexcept -> FrozenFile&; ///< Move assignment operator
+
+    auto findSection(std::string_view title) const -> const Section*; ///< Find a Section by fully qualified title.
+    auto findEntry(std::string_view name) const -> const Entry*; ///< Find an Entry by fully qualified name.
+    auto findEntry(std::string_view section, std::string_view name) const -> const Entry*; ///< Find an Entry by section and name.
+
+    template<class T>
+    auto get(std::string_view section, std::string_view name) const -> T; ///< Get an Entry by name and convert it to the specified type.
+    template<class T>
+    auto tryGet(std::string_view section, std::string_view name) const -> std::optional<T>; ///< Get an Entry by name and convert it without throwing.
+
+    auto sections() const -> std::span<const Section> { return m_sections; } ///< All Sections in the order of the File
+    auto size() const -> std::size_t { return m_entrySlots.size(); } ///< Number of Entries that can be found
+
+private:
+    /// \brief Minimal perfect hash function over a fixed set of 64 bit hashes
+    /// \details The hashes are distributed into buckets. Every bucket stores a displacement that moves its hashes into
+    /// otherwise unused slots, so n hashes map to the slots 0 to n - 1 without collisions (hash and displace). Hashes
+    /// that were not part of the set map to an arbitrary slot.
+    class PerfectHash {
+    public:
+        auto build(std::span<const std::uint64_t> hashes) -> bool; ///< Build the function. Fails if no displacements were found.
+        auto operator()(std::uint64_t hash) const -> std::size_t; ///< Slot of the hash
+
+    private:
+        static constexpr auto reduce(std::uint64_t hash, std::size_t size) -> std::size_t; ///< Map a hash to [0, size)
+
+        std::vector<std::int32_t> m_displacements{}; ///< Per bucket: 0 if empty, > 0 a displacement, < 0 a slot
+        std::size_t m_size{0}; ///< Number of slots
+    };
+
+    /// \brief Slot of the entry index
+    struct EntrySlot {
+        std::string_view section; ///< Fully qualified title of the Section of the Entry
+        std::string_view key; ///< Key of the Entry
+        const Entry* entry; ///< The Entry
+    };
+
+    static constexpr auto mix(std::uint64_t hash) -> std::uint64_t; ///< Scramble the bits of a hash
+    auto sectionHash(std::string_view title) const -> std::uint64_t; ///< Hash of a fully qualified title
+    auto entryHash(std::string_view section, std::string_view name) const -> std::uint64_t; ///< Hash of a (Section, key) pair
+
+    auto copy(std::string_view text) -> std::string_view; ///< Copy text into the arena
+
+private:
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena{}; ///< Storage for the entries and values
+    std::shared_ptr<StringPool> m_pool{}; ///< Titles and keys
+    std::vector<Section> m_sections{};
+
+    std::uint64_t m_seed{0}; ///< Mixed into all hashes, changed until the perfect hashes can be built
+    PerfectHash m_sectionIndex{};
+    std::vector<const Section*> m_sectionSlots{};
+    PerfectHash m_entryIndex{};
+    std::vector<EntrySlot> m_entrySlots{};
+};
+
+/// \details This is the finalizer of SplitMix64, which spreads every input bit over the whole hash.
+/// \arg hash The hash to scramble
+/// \returns The scrambled hash
+constexpr auto FrozenFile::mix(std::uint64_t hash) -> std::uint64_t
+{
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111eb;
+    return hash ^ (hash >> 31);
+}
+
+/// \details Uses the upper 32 bits of the hash, so size has to be smaller than 2^32.
+/// \arg hash The hash to map
+/// \arg size The number of possible results
+/// \returns A value in [0, size) without a division
+constexpr auto FrozenFile::PerfectHash::reduce(std::uint64_t hash, std::size_t size) -> std::size_t
+{
+    return static_cast<std::size_t>(((hash >> 32) * static_cast<std::uint64_t>(size)) >> 32);
+}
+
+/// \arg hash The hash to look up
+/// \returns The slot of the hash if it was part of the set, otherwise any slot. 0 if the set was empty.
+inline auto FrozenFile::PerfectHash::operator()(std::uint64_t hash) const -> std::size_t
+{
+    if (m_size == 0) {
+        return 0;
+    }
+
+    const auto displacement = m_displacements[reduce(hash, m_displacements.size())];
+
+    if (displacement < 0) {
+        return static_cast<std::size_t>(-(displacement + 1));
+    }
+
+    return reduce(mix(hash + static_cast<std::uint64_t>(displacement)), m_size);
+}
+
+inline auto FrozenFile::sectionHash(std::string_view title) const -> std::uint64_t
+{
+    return mix(std::hash<std::string_view>{}(title) ^ m_seed);
+}
+
+inline auto FrozenFile::entryHash(std::string_view section, std::string_view name) const -> std::uint64_t
+{
+    return mix(sectionHash(section) ^ std::hash<std::string_view>{}(name));
+}
+
+/// \param title The fully qualified title of the Section to find (e.g. "Section1.Section2").
+/// \returns A pointer to the Section if found, nullptr otherwise.
+inline auto FrozenFile::findSection(std::string_view title) const -> const Section*
+{
+    if (m_sectionSlots.empty()) {
+        return nullptr;
+    }
+
+    const auto section = m_sectionSlots[m_sectionIndex(sectionHash(title))];
+    return section->fqTitle() == title ? section : nullptr;
+}
+
+/// \details The Section is not looked up. The pair is hashed as a whole and the slot stores both names for the
+/// comparison. The lookup does not allocate.
+/// \param section The fully qualified title of the Section to search in.
+/// \param name The name of the Entry to find.
+/// \returns A pointer to the Entry if found, nullptr otherwise.
+inline auto FrozenFile::findEntry(std::string_view section, std::string_view name) const -> const Entry*
+{
+    if (m_entrySlots.empty()) {
+        return nullptr;
+    }
+
+    const auto& slot = m_entrySlots[m_entryIndex(entryHash(section, name))];
+    return slot.key == name and slot.section == section ? slot.entry : nullptr;
+}
+
+/// \param name The fully qualified name of the Entry to find (e.g. "Section1.Section2.Key").
+/// \returns A pointer to the Entry if found, nullptr otherwise.
+inline auto FrozenFile::findEntry(std::string_view name) const -> const Entry*
+{
+    const auto separator = name.find_last_of('.');
+
+    if (separator == std::string_view::npos) {
+        return nullptr;
+    }
+
+    return findEntry(name.substr(0, separator), name.substr(separator + 1));
+}
+
+/// \details Calls findEntry() and returns the value of the Entry if it exists.
+/// Otherwise, returns a default-constructed value.
+/// \arg section The fully qualified title of the Section to search in.
+/// \arg name The name of the Entry to search for.
+/// \tparam T The type of the value to return.
+/// \returns The value of the Entry if it exists, otherwise a default-constructed value.
+template<class T>
+auto FrozenFile::get(std::string_view section, std::string_view name) const -> T
+{
+    if (const auto entry = findEntry(section, name)) {
+        return entry->value<T>();
+    }
+
+    return T();
+}
+
+/// \details Calls findEntry() and converts the value of the Entry with Entry::tryValue().
+/// \arg section The fully qualified title of the Section to search in.
+/// \arg name The name of the Entry to search for.
+/// \tparam T The type of the value to return.
+/// \returns The value of the Entry, or std::nullopt if it does not exist or cannot be converted.
+template<class T>
+auto FrozenFile::tryGet(std::string_view section, std::string_view name) const -> std::optional<T>
+{
+    if (const auto entry = findEntry(section, name)) {
+        return entry->tryValue<T>();
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,195 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cppIni/cppini_export.h>
+
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/// \brief A title line reported by the Parser
+struct ParsedSection {
+    std::string_view fqTitle; ///< Fully qualified title, e.g. "Section1.Section2"
+    std::string_view title; ///< Title between the brackets without the leading '.' of a relative title
+    bool relative; ///< Whether the title starts with '.' and names a subsection of the previous Section
+    std::string_view line; ///< The whole line without its line break
+    std::size_t offset; ///< Position of the line in the input
+};
+
+/// \brief A key and value line reported by the Parser
+/// \details Key and value are views into the line. A line without '=' has the whole line as key and as value.
+struct ParsedEntry {
+    std::string_view section; ///< Fully qualified title of the Section the Entry belongs to, empty before the first title
+    std::string_view key; ///< Text in front of the first '='
+    std::string_view value; ///< Text behind the first '='
+    std::string_view line; ///< The whole line without its line break
+    std::size_t offset; ///< Position of the line in the input
+};
+
+/// \brief Streaming parser that reports Sections and entries without building a File
+/// \details The Parser understands the same grammar as File and calls a handler for every title and every entry in the
+/// order of the input. Only the current line and the fully qualified title of the current Section are kept, so the
+/// memory used does not depend on the size of the input. File uses it to read files itself.
+/// A handler is any object with one or both of the member functions
+///
+///     section(const ParsedSection&)
+///     entry(const ParsedEntry&)
+///
+/// If a member function returns bool, returning false stops the parser.
+/// \note All views passed to the handler are only valid during the call.
+/// \code
+/// struct Ports {
+///     std::vector<int> ports;
+///     auto entry(const ParsedEntry& entry) -> void
+///     {
+///         if (entry.key == "Port") {
+///             ports.push_back(std::stoi(std::string{entry.value}));
+///         }
+///     }
+/// };
+///
+/// auto ports = Ports{};
+/// Parser::parse("server.ini", ports);
+/// \endcode
+class CPPINI_EXPORT Parser {
+public:
+    template<class Handler>
+    static auto parse(const std::filesystem::path& filename, Handler&& handler) -> bool; ///< Parse a file.
+    template<class Handler>
+    auto parse(std::istream& input, Handler&& handler) -> bool; ///< Parse a stream from its current position.
+    template<class Handler>
+    auto line(std::string_view line, std::size_t offset, Handler&& handler) -> bool; ///< Parse a single line.
+
+    static constexpr auto entry(std::string_view section, std::string_view line, std::size_t offset, std::size_t separator) -> ParsedEntry; ///< Split an entry line at a known separator.
+
+    auto section() const -> std::string_view { return m_fqTitle; } ///< Fully qualified title of the current Section
+    auto offset() const -> std::size_t { return m_offset; } ///< Number of bytes read by parse()
+    auto lines() const -> std::size_t { return m_lines; } ///< Number of lines read by parse(), including empty ones
+    auto endsWithNewline() const -> bool { return m_newline; } ///< Whether the input read by parse() ends with a line break
+
+private:
+    auto title(std::string_view line, std::size_t offset) -> ParsedSection; ///< Parse a title line and make it the current Section
+
+    template<class F, class Event>
+    static auto report(F&& function, const Event& event) -> bool; ///< Call a handler function and tell whether to go on
+
+    std::string m_fqTitle{};
+    std::string m_line{}; ///< Buffer for the current line, reused for every line
+    std::size_t m_offset{0};
+    std::size_t m_lines{0};
+    bool m_newline{true};
+    bool m_inSection{false}; ///< Whether a title was parsed, so a relative title has a parent
+};
+
+/// \details The file is read line by line with a Parser that is destroyed afterwards.
+/// \param filename The name of the file to parse.
+/// \param handler Receives the Sections and entries of the file.
+/// \returns false if the handler stopped the parser, true otherwise.
+/// \throws std::runtime_error if the file cannot be opened.
+template<class Handler>
+auto Parser::parse(const std::filesystem::path& filename, Handler&& handler) -> bool
+{
+    auto input = std::ifstream{filename, std::ios::binary};
+
+    if (not input) {
+        throw std::runtime_error{"Cannot open " + filename.string()};
+    }
+
+    return Parser{}.parse(input, std::forward<Handler>(handler));
+}
+
+/// \details The input is read with std::getline into a buffer that is reused, so it only grows to the longest line.
+/// offset() and endsWithNewline() describe the input read so far, also if the handler stopped the parser.
+/// \param input The stream to read.
+/// \param handler Receives the Sections and entries of the stream.
+/// \returns false if the handler stopped the parser, true otherwise.
+template<class Handler>
+auto Parser::parse(std::istream& input, Handler&& handler) -> bool
+{
+    while (std::getline(input, m_line)) {
+        const auto offset = m_offset;
+        m_newline = not input.eof();
+        m_offset += m_line.size() + m_newline;
+        ++m_lines;
+
+        if (not line(m_line, offset, handler)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// \details A line starting with '[' begins a Section, every other non-empty line is an entry of the current Section.
+/// \param line The line without its line break.
+/// \param offset The position of the line in the input.
+/// \param handler Receives the Section or the entry of the line.
+/// \returns false if the handler stopped the parser, true otherwise.
+template<class Handler>
+auto Parser::line(std::string_view line, std::size_t offset, Handler&& handler) -> bool
+{
+    if (line.empty()) {
+        return true;
+    }
+
+    if (line[0] == '[') {
+        const auto parsed = title(line, offset);
+
+        if constexpr (requires { handler.section(parsed); }) {
+            return report([&handler](const ParsedSection& event) { return handler.section(event); }, parsed);
+        }
+    } else {
+        const auto parsed = entry(m_fqTitle, line, offset, line.find('='));
+
+        if constexpr (requires { handler.entry(parsed); }) {
+            return report([&handler](const ParsedEntry& event) { return handler.entry(event); }, parsed);
+        }
+    }
+
+    return true;
+}
+
+/// \param section The fully qualified title of the current Section.
+/// \param line The line without its line break.
+/// \param offset The position of the line in the input.
+/// \param separator The position of the first '=' in the line, std::string_view::npos if there is none.
+/// \returns The entry of the line.
+constexpr auto Parser::entry(std::string_view section, std::string_view line, std::size_t offset, std::size_t separator) -> ParsedEntry
+{
+    return {section, line.substr(0, separator), line.substr(separator == std::string_view::npos ? 0 : separator + 1), line, offset};
+}
+
+/// \param function The handler function to call.
+/// \param event The Section or entry to report.
+/// \returns The result of the function if it returns bool, true otherwise.
+template<class F, class Event>
+auto Parser::report(F&& function, const Event& event) -> bool
+{
+    if constexpr (std::is_same_v<std::invoke_result_t<F, const Event&>, bool>) {
+        return function(event);
+    } else {
+        function(event);
+        return true;
+    }
+}
@@ -0,0 +1,316 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cppIni/Entry.h>
+#include <cppIni/File.h>
+#include <cppIni/Parser.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/// \brief String literal that can be used as a template argument
+template<std::size_t N>
+struct FixedString {
+    constexpr FixedString(const char (&text)[N]) { std::copy_n(text, N, data); } ///< Constructor from a string literal
+
+    constexpr auto view() const -> std::string_view { return {data, N - 1}; } ///< The text without the terminating null
+
+    char data[N] {};
+};
+
+/// \brief Class and type of a pointer to a data member
+template<class>
+struct MemberPointer;
+
+template<class C, class T>
+struct MemberPointer<T C::*> {
+    using Class = C;
+    using Type = T;
+};
+
+/// \brief Binds a data member of a struct to an entry of a File
+/// \details The names are checked at compile time: the title must not be empty, start with '.' or contain ']' and the
+/// key must not be empty, start with '[' or contain '='. Neither may contain a line break.
+/// \tparam Section The fully qualified title of the Section, e.g. "Server.Http".
+/// \tparam Key The key of the entry.
+/// \tparam Member Pointer to the data member. Its type has to be arithmetic or std::string.
+template<FixedString Section, FixedString Key, auto Member>
+struct Field {
+    using Class = typename MemberPointer<decltype(Member)>::Class; ///< The struct the member belongs to
+    using Type = typename MemberPointer<decltype(Member)>::Type; ///< The type of the member
+
+    static constexpr std::string_view section = Section.view();
+    static constexpr std::string_view key = Key.view();
+
+    static_assert(not section.empty() and section[0] != '.' and section.find_first_of("]\n") == std::string_view::npos,
+                  "Invalid section title");
+    static_assert(not key.empty() and key[0] != '[' and key.find_first_of("=\n") == std::string_view::npos, "Invalid key");
+    static_assert(std::is_arithmetic_v<Type> or std::is_same_v<Type, std::string>, "Fields have to be arithmetic or std::string");
+
+    /// \brief Convert the value of an Entry into the member
+    static auto read(Class& object, const Entry& entry) -> void { object.*Member = entry.value<Type>(); }
+    /// \brief The text of the member as it is written to a file
+    static auto text(const Class& object) -> std::string { return std::string{Entry{key, object.*Member}.data()}; }
+};
+
+/// \brief Compile-time mapping between a struct and the entries of an INI file
+/// \details A Schema lists a Field for every member of the struct that is stored in the file. The names only appear in
+/// the Schema, so the rest of the program reads plain members and a misspelled member does not compile. The Fields
+/// are grouped by Section at compile time, so each Section is looked up once when the struct is loaded from a File and
+/// each entry is only compared to the keys of its own Section when the struct is parsed from a stream.
+/// Entries that are missing keep the value the member had before. Duplicate Sections and keys resolve like in a File:
+/// the first one counts. Values that cannot be converted throw like Entry::value().
+/// \tparam T The struct to fill.
+/// \tparam Fields The Field of every stored member.
+/// \code
+/// struct Config {
+///     std::string host {"localhost"};
+///     int port {80};
+///     double timeout {1.5};
+/// };
+///
+/// using ConfigSchema = Schema<Config,
+///                             Field<"Server", "Host", &Config::host>,
+///                             Field<"Server", "Port", &Config::port>,
+///                             Field<"Client", "Timeout", &Config::timeout>>;
+///
+/// auto config = ConfigSchema::load(file);
+/// config.port = 8080;
+/// ConfigSchema::store(config, file);
+/// \endcode
+template<class T, class... Fields>
+class Schema {
+public:
+    template<class Source>
+    static auto load(const Source& file) -> T; ///< Create a struct from a File or FrozenFile.
+    template<class Source>
+    static auto load(const Source& file, T& object) -> void; ///< Fill a struct from a File or FrozenFile.
+    static auto parse(std::istream& input) -> T; ///< Create a struct directly from a stream without building a File.
+    static auto parse(const std::filesystem::path& filename) -> T; ///< Create a struct directly from a file without building a File.
+    static auto store(const T& object, File& file) -> void; ///< Set all members in a File and write it once.
+    static auto write(const T& object, std::ostream& output) -> void; ///< Write all members as INI text.
+
+private:
+    static constexpr auto size = sizeof...(Fields);
+    static constexpr std::array<std::string_view, size> sections {Fields::section...};
+    static constexpr std::array<std::string_view, size> keys {Fields::key...};
+    static constexpr std::array<void (*)(T&, const Entry&), size> readers {&Fields::read...};
+    static constexpr std::array<std::string (*)(const T&), size> writers {&Fields::text...};
+
+    static constexpr auto grouped() -> std::array<std::size_t, size>; ///< Indices of the Fields, grouped by Section in the order of their first Field
+    static constexpr auto unique() -> bool; ///< Whether no two Fields have the same Section and key
+    static constexpr auto groupEnd(std::size_t first) -> std::size_t; ///< End of the group that starts at first in order
+
+    static constexpr auto order = grouped();
+
+    static_assert((std::is_same_v<typename Fields::Class, T> and ...), "All Fields have to be members of T");
+    static_assert(unique(), "Every Section and key may only be bound once");
+};
+
+template<class T, class... Fields>
+constexpr auto Schema<T, Fields...>::grouped() -> std::array<std::size_t, size>
+{
+    auto result = std::array<std::size_t, size>{};
+    auto count = std::size_t{0};
+
+    for (std::size_t i = 0; i < size; ++i) {
+        if (std::find(sections.begin(), sections.begin() + i, sections[i]) == sections.begin() + i) {
+            for (auto j = i; j < size; ++j) {
+                if (sections[j] == sections[i]) {
+                    result[count++] = j;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+template<class T, class... Fields>
+constexpr auto Schema<T, Fields...>::unique() -> bool
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        for (auto j = i + 1; j < size; ++j) {
+            if (sections[i] == sections[j] and keys[i] == keys[j]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<class T, class... Fields>
+constexpr auto Schema<T, Fields...>::groupEnd(std::size_t first) -> std::size_t
+{
+    auto last = first;
+    while (last < size and sections[order[last]] == sections[order[first]]) {
+        ++last;
+    }
+
+    return last;
+}
+
+/// \param file The File or FrozenFile to read.
+/// \returns A value-initialized struct with the members found in the file.
+template<class T, class... Fields>
+template<class Source>
+auto Schema<T, Fields...>::load(const Source& file) -> T
+{
+    auto object = T{};
+    load(file, object);
+    return object;
+}
+
+/// \details Every Section is looked up once and its keys are searched in it. With LoadMode::Lazy, only the Sections of the
+/// Schema are parsed. In a thread-safe File, the values of a Section are converted while the Section is locked.
+/// \param file The File or FrozenFile to read.
+/// \param object The struct to fill. Members whose entry is missing keep their value.
+/// \throws std::invalid_argument if a value cannot be converted to the type of its member.
+/// \throws std::out_of_range if a value does not fit into its member.
+template<class T, class... Fields>
+template<class Source>
+auto Schema<T, Fields...>::load(const Source& file, T& object) -> void
+{
+    for (std::size_t first = 0; first < size; first = groupEnd(first)) {
+        if (const auto section = file.findSection(sections[order[first]])) {
+            [[maybe_unused]] const auto lock = [&] {
+                if constexpr (std::is_same_v<Source, File>) {
+                    return file.lockShared(section);
+                } else {
+                    return 0;
+                }
+            }();
+
+            for (auto i = first; i < groupEnd(first); ++i) {
+                if (const auto entry = section->findEntry(keys[order[i]])) {
+                    readers[order[i]](object, *entry);
+                }
+            }
+        }
+    }
+}
+
+/// \details The stream is read with a Parser, which stops as soon as all members were found.
+/// \param input The stream to read.
+/// \returns A value-initialized struct with the members found in the stream.
+/// \throws std::invalid_argument if a value cannot be converted to the type of its member.
+/// \throws std::out_of_range if a value does not fit into its member.
+template<class T, class... Fields>
+auto Schema<T, Fields...>::parse(std::istream& input) -> T
+{
+    /// \brief Assigns the entries of the Sections of the Schema
+    struct Handler {
+        T& object;
+        std::size_t first {size}; ///< Group of the current Section in order
+        std::size_t last {size};
+        std::size_t missing {size}; ///< Number of Fields that were not found yet
+        std::array<bool, size> found {};
+        std::array<bool, size> visited {}; ///< Groups whose first Section was read already, by their start in order
+
+        auto section(const ParsedSection& parsed) -> void
+        {
+            first = last = size;
+
+            for (std::size_t group = 0; group < size; group = groupEnd(group)) {
+                if (sections[order[group]] == parsed.fqTitle and not std::exchange(visited[group], true)) {
+                    first = group;
+                    last = groupEnd(group);
+                }
+            }
+        }
+
+        auto entry(const ParsedEntry& parsed) -> bool
+        {
+            for (auto i = first; i < last; ++i) {
+                if (keys[order[i]] == parsed.key and not std::exchange(found[i], true)) {
+                    readers[order[i]](object, Entry::borrow(parsed.key, parsed.value, nullptr));
+                    --missing;
+                }
+            }
+
+            return missing != 0;
+        }
+    };
+
+    auto object = T{};
+    Parser{}.parse(input, Handler{object});
+    return object;
+}
+
+/// \param filename The name of the file to read.
+/// \returns A value-initialized struct with the members found in the file.
+/// \throws std::runtime_error if the file cannot be opened.
+/// \throws std::invalid_argument if a value cannot be converted to the type of its member.
+/// \throws std::out_of_range if a value does not fit into its member.
+template<class T, class... Fields>
+auto Schema<T, Fields...>::parse(const std::filesystem::path& filename) -> T
+{
+    auto input = std::ifstream{filename, std::ios::binary};
+
+    if (not input) {
+        throw std::runtime_error{"Cannot open " + filename.string()};
+    }
+
+    return parse(input);
+}
+
+/// \details All members are set in a single Batch, so the File is written once if auto flush is enabled. Sections and
+/// entries that do not exist yet are created.
+/// \param object The struct to store.
+/// \param file The File to change.
+template<class T, class... Fields>
+auto Schema<T, Fields...>::store(const T& object, File& file) -> void
+{
+    auto batch = file.batch();
+
+    for (const auto i : order) {
+        batch.set(sections[i], keys[i], writers[i](object));
+    }
+
+    batch.commit();
+}
+
+/// \details The text has the layout File writes: the Sections in the order of their first Field, every entry on its own
+/// line and an empty line behind every Section.
+/// \param object The struct to write.
+/// \param output The stream to write to.
+template<class T, class... Fields>
+auto Schema<T, Fields...>::write(const T& object, std::ostream& output) -> void
+{
+    for (std::size_t first = 0; first < size; first = groupEnd(first)) {
+        output << '[' << sections[order[first]] << "]\n";
+
+        for (auto i = first; i < groupEnd(first); ++i) {
+            output << keys[order[i]] << '=' << writers[order[i]](object) << '\n';
+        }
+
+        output << '\n';
+    }
+}
@@ -20,18 +20,34 @@
 
 #include <cppIni/cppini_export.h>
 #include <cppIni/Entry.h>
+#include <cppIni/EntryMap.h>
+#include <cppIni/StringPool.h>
 
-#include <unordered_map>
+#include <memory_resource>
 
 /// \brief Represents a section in a configuration file
 /// \details A section is a collection of Entry objects with a title (e.g. [Section]) in a configuration file
 /// \note A section has a title and a list of Entry objects
+/// \note The title and the keys of the entries are stored in a StringPool. Sections of the same File share the pool of
+/// that File, a standalone Section creates its own.
+/// \note The entries are stored in an EntryMap allocated from the memory resource passed to the constructor, which has
+/// to outlive the Section. An Entry keeps its address until it is removed, also when the Section is moved.
+/// \note Copying or moving a Section hands its entries over, so entries whose parent was the original Section have the
+/// new one as parent. Subsections refer to their parent by address and are not updated, which is why File and
+/// FrozenFile never move their Sections.
 class CPPINI_EXPORT Section {
 public:
-    explicit Section(std::string_view title, const Section* parent = nullptr); ///< Constructor with title
+    explicit Section(std::string_view title, const Section* parent = nullptr, std::shared_ptr<StringPool> pool = {},
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource()); ///< Constructor with title
+    Section(const Section& other); ///< Copy constructor
+    Section(Section&& other) noexcept; ///< Move constructor
+    ~Section() = default; ///< Destructor
+
+    auto operator=(const Section& other) -> Section&; ///< Copy assignment operator
+    auto operator=(Section&& other) noexcept -> Section&; ///< Move assignment operator
 
     auto title() const -> std::string_view { return m_title; } ///< Title as std::string_view
-    auto fqTitle() const -> std::string; ///< Fully qualified title (e.g. "Section1.Section2")
+    auto fqTitle() const -> std::string_view { return m_fqTitle; } ///< Fully qualified title (e.g. "Section1.Section2")
 
     constexpr auto parent() const -> const Section* { return m_parent; } ///< Parent Section
     auto isSubsection() const -> bool { return m_parent != nullptr; } ///< Returns true if this Section is a subsection
@@ -42,16 +58,28 @@ public:
     template<class T>
     auto createEntry(std::string_view key, T value) -> void; ///< Create an Entry object in place and add it to the section
 
-    constexpr auto entries() const -> const auto& { return m_entries; } ///< List of Entry objects
+    constexpr auto entries() const -> const EntryMap& { return m_entries; } ///< Entry objects in insertion order
 
     auto findEntry(std::string_view name) const -> const Entry*; ///< Find an Entry object by name
 
     auto operator==(const Section& other) const -> bool; ///< Equality operator
     auto operator!=(const Section& other) const -> bool = default; ///< Inequality operator
 private:
-    std::string m_title;
-    std::unordered_map<std::string, Entry> m_entries;
+    auto stableKey(Entry& entry) -> std::string_view; ///< Move the key of the entry into the pool if it owns it
+    auto adopt(const Section& previous) -> void; ///< Make this Section the parent of the entries that belonged to another one
+
+    friend class File;
+    friend class FrozenFile;
+
+private:
+    std::shared_ptr<StringPool> m_pool;
+    std::string_view m_fqTitle; ///< Cached because parents cannot change after construction
+    std::string_view m_title; ///< Suffix of m_fqTitle
+    EntryMap m_entries; ///< Keys reference the pool or the storage of the File
     const Section *m_parent {nullptr};
+    std::size_t m_start {std::string::npos}; ///< Position of the title in the file
+    std::size_t m_end {std::string::npos}; ///< Position after the last line of the Section in the file, where new entries are inserted
+    std::string_view m_pending {}; ///< Title and unparsed lines of a lazily loaded Section, empty once they were parsed
 };
 
 /// \details The parameters are forwarded to the Entry constructor and a pointer to this Section object is added as the parent
@@ -60,5 +88,5 @@ private:
 template<class T>
 auto Section::createEntry(std::string_view key, T value) -> void
 {
-    m_entries.emplace(key, Entry{key, value, this});
+    addEntry(Entry{key, value, this});
 }
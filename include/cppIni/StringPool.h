@@ -0,0 +1,65 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cppIni/cppini_export.h>
+
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+/// \brief Deduplicating storage for section titles, keys and short values
+/// \details Every distinct string is stored exactly once in large blocks that are only released together with the pool.
+/// The views returned by intern() stay valid as long as the pool exists. A pool is shared by handing the same
+/// std::shared_ptr to several File objects via OpenOptions::stringPool. Each File keeps the pool alive, so its entries
+/// can safely reference the stored strings.
+/// \note Interning is thread-safe, so Files sharing a pool may be opened concurrently.
+/// \note All memory, including the lookup table, is taken from the memory resource passed to the constructor.
+class CPPINI_EXPORT StringPool {
+public:
+    explicit StringPool(std::size_t maxValueLength = 32, std::pmr::memory_resource* resource = std::pmr::get_default_resource()); ///< Constructor with the maximum length of interned values and the memory resource
+    ~StringPool(); ///< Destructor. Returns all blocks to the memory resource.
+
+    StringPool(const StringPool&) = delete;
+    auto operator=(const StringPool&) -> StringPool& = delete;
+
+    auto intern(std::string_view text) -> std::string_view; ///< Stable view on the stored copy of the text
+
+    auto maxValueLength() const -> std::size_t { return m_maxValueLength; } ///< Values up to this length are interned
+    auto size() const -> std::size_t; ///< Number of distinct strings
+    auto capacity() const -> std::size_t; ///< Number of bytes allocated for characters
+
+private:
+    auto store(std::string_view text) -> std::string_view; ///< Copy the text into the current block
+
+    static constexpr std::size_t blockSize = 64 * 1024;
+
+    mutable std::mutex m_mutex;
+    std::pmr::memory_resource* m_resource;
+    std::pmr::unordered_set<std::string_view> m_strings;
+    std::pmr::vector<std::span<char>> m_blocks;
+    char* m_cursor {nullptr};
+    std::size_t m_remaining {0};
+    std::size_t m_capacity {0};
+    std::size_t m_maxValueLength;
+};
@@ -21,3 +21,8 @@
 #include <cppIni/File.h>
 #include <cppIni/Section.h>
 #include <cppIni/Entry.h>
+#include <cppIni/EntryMap.h>
+#include <cppIni/FrozenFile.h>
+#include <cppIni/Parser.h>
+#include <cppIni/Schema.h>
+#include <cppIni/StringPool.h>
@@ -31,10 +31,18 @@ extern "C" {
 /// the C++ API. It is intended for use with languages that do not support
 /// C++.
 
+/// \brief A single value passed to cppIni_set_many()
+typedef struct cppIni_entry {
+    const char* section; ///< The fully qualified title of the section
+    const char* key; ///< The key of the entry
+    const char* value; ///< The value of the entry
+} cppIni_entry;
+
 CPPINI_EXPORT void* cppIni_open(const char* filename); ///< Opens a file
 CPPINI_EXPORT void cppIni_close(void** file); ///< Closes a file
 
 CPPINI_EXPORT void cppIni_set(void* file, const char* section, const char* key, const char* value); ///< Sets a value
+CPPINI_EXPORT void cppIni_set_many(void* file, const cppIni_entry* entries, size_t count); ///< Sets several values and writes the file once
 
 CPPINI_EXPORT const char* cppIni_gets(const void* file, const char* section, const char* key, char* out, size_t outSize); ///< Gets a string
 CPPINI_EXPORT int cppIni_geti(const void* file, const char* section, const char* key); ///< Gets an integer
@@ -0,0 +1,42 @@
+
+#ifndef CPPINI_EXPORT_H
+#define CPPINI_EXPORT_H
+
+#ifdef CPPINI_STATIC_DEFINE
+#  define CPPINI_EXPORT
+#  define CPPINI_NO_EXPORT
+#else
+#  ifndef CPPINI_EXPORT
+#    ifdef cppIni_EXPORTS
+        /* We are building this library */
+#      define CPPINI_EXPORT __attribute__((visibility("default")))
+#    else
+        /* We are using this library */
+#      define CPPINI_EXPORT __attribute__((visibility("default")))
+#    endif
+#  endif
+
+#  ifndef CPPINI_NO_EXPORT
+#    define CPPINI_NO_EXPORT __attribute__((visibility("hidden")))
+#  endif
+#endif
+
+#ifndef CPPINI_DEPRECATED
+#  define CPPINI_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef CPPINI_DEPRECATED_EXPORT
+#  define CPPINI_DEPRECATED_EXPORT CPPINI_EXPORT CPPINI_DEPRECATED
+#endif
+
+#ifndef CPPINI_DEPRECATED_NO_EXPORT
+#  define CPPINI_DEPRECATED_NO_EXPORT CPPINI_NO_EXPORT CPPINI_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef CPPINI_NO_DEPRECATED
+#    define CPPINI_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* CPPINI_EXPORT_H */
@@ -0,0 +1,125 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AtomicFile.h"
+
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+/// \details MOVEFILE_WRITE_THROUGH makes MoveFileEx return only after the rename reached the disk.
+auto replaceFile(const std::string& filename, std::string_view content, bool sync) -> void
+{
+    const auto temporary = filename + ".tmp";
+    const auto fail = [&temporary](const char* what) {
+        const auto error = static_cast<int>(GetLastError());
+        DeleteFileA(temporary.c_str());
+        throw std::system_error{error, std::system_category(), what + (" " + temporary)};
+    };
+
+    const auto file = CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), "Could not create " + temporary};
+    }
+
+    DWORD written = 0;
+    const auto success = WriteFile(file, content.data(), static_cast<DWORD>(content.size()), &written, nullptr)
+                         and written == content.size()
+                         and (not sync or FlushFileBuffers(file));
+    CloseHandle(file);
+
+    if (not success) {
+        fail("Could not write");
+    }
+
+    if (not MoveFileExA(temporary.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING | (sync ? MOVEFILE_WRITE_THROUGH : 0))) {
+        fail("Could not rename");
+    }
+}
+
+#else
+
+/// \details The temporary file gets the permissions of the original. With sync, the temporary file is synchronized
+/// before the rename and the directory afterwards, so a crash leaves either the old or the new file behind.
+auto replaceFile(const std::string& filename, std::string_view content, bool sync) -> void
+{
+    const auto temporary = filename + ".tmp";
+    const auto fail = [&temporary](int error, const char* what) {
+        ::unlink(temporary.c_str());
+        throw std::system_error{error, std::generic_category(), what + (" " + temporary)};
+    };
+
+    struct stat status {};
+    const auto mode = ::stat(filename.c_str(), &status) == 0 ? status.st_mode & 07777 : 0666;
+
+    const auto fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    if (fd < 0) {
+        throw std::system_error{errno, std::generic_category(), "Could not create " + temporary};
+    }
+
+    for (auto remaining = content; not remaining.empty();) {
+        const auto written = ::write(fd, remaining.data(), remaining.size());
+
+        if (written < 0 and errno == EINTR) {
+            continue;
+        } else if (written < 0) {
+            const auto error = errno;
+            ::close(fd);
+            fail(error, "Could not write");
+        }
+
+        remaining.remove_prefix(static_cast<std::size_t>(written));
+    }
+
+    if (sync and ::fsync(fd) != 0) {
+        const auto error = errno;
+        ::close(fd);
+        fail(error, "Could not sync");
+    }
+
+    if (::close(fd) != 0) {
+        fail(errno, "Could not write");
+    }
+
+    if (::rename(temporary.c_str(), filename.c_str()) != 0) {
+        fail(errno, "Could not rename");
+    }
+
+    if (sync) {
+        const auto parent = std::filesystem::path{filename}.parent_path();
+        const auto directory = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (directory >= 0) {
+            ::fsync(directory);
+            ::close(directory);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/// \brief Replace the content of a file without ever leaving it partially written
+/// \details The content is written to a temporary file next to the original with a single write call and renamed over
+/// the original afterwards. Readers either see the old or the new content. The original file is never opened, so
+/// memory mappings of it stay valid.
+/// \param filename The name of the file to replace.
+/// \param content The new content of the file.
+/// \param sync Whether the content and the rename are synchronized to disk before returning, so they survive a crash.
+/// \throws std::system_error if the file cannot be written. The original file is left untouched in that case.
+auto replaceFile(const std::string& filename, std::string_view content, bool sync) -> void;
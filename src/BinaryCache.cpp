@@ -0,0 +1,73 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "BinaryCache.h"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+
+/// \param data The bytes to check.
+/// \returns The checksum of the bytes.
+auto checksum(std::string_view data) -> std::uint64_t
+{
+    constexpr std::uint64_t prime1 = 0x9e3779b185ebca87;
+    constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4f;
+    constexpr std::size_t blockSize = 32;
+
+    std::array<std::uint64_t, 4> lanes {prime1, prime2, ~prime1, ~prime2};
+    const auto round = [](std::uint64_t lane, std::uint64_t word) {
+        return std::rotl(lane + word * prime2, 31) * prime1;
+    };
+    const auto block = [&](const char* bytes) {
+        for (std::size_t lane = 0; lane < lanes.size(); ++lane) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + lane * sizeof word, sizeof word);
+            lanes[lane] = round(lanes[lane], word);
+        }
+    };
+
+    const auto blocks = data.size() / blockSize;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        block(data.data() + i * blockSize);
+    }
+
+    std::array<char, blockSize> tail {};
+    std::memcpy(tail.data(), data.data() + blocks * blockSize, data.size() % blockSize);
+    block(tail.data());
+
+    auto hash = static_cast<std::uint64_t>(data.size());
+    for (const auto lane : lanes) {
+        hash = round(hash ^ lane, prime1);
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    return hash ^ (hash >> 29);
+}
+
+/// \details The size and the write time are taken from the file system, so a cache can be rejected without hashing the
+/// content if they changed.
+auto sourceStamp(const std::string& filename, std::string_view content) -> SourceStamp
+{
+    return {
+        std::filesystem::file_size(filename),
+        static_cast<std::int64_t>(std::filesystem::last_write_time(filename).time_since_epoch().count()),
+        checksum(content),
+    };
+}
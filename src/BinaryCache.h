@@ -0,0 +1,96 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Layout of the binary cache written by File::writeCache():
+//
+//   CacheHeader
+//   CacheSection[header.sections]   in the order of File::sections()
+//   CacheEntry[header.entries]      the entries of every Section in order, Section after Section
+//   char[header.strings]            titles, keys and values referenced by offset and length
+//
+// All integers are stored in the byte order of the machine that wrote the cache. A cache written with another byte
+// order or version is ignored.
+
+constexpr std::array<char, 8> cacheMagic {'c', 'p', 'p', 'I', 'n', 'i', 'B', 'C'};
+constexpr std::uint32_t cacheVersion = 1;
+constexpr std::uint32_t cacheByteOrder = 0x01020304;
+
+/// \brief Identifies the content of the text file a cache was created from
+struct SourceStamp {
+    std::uint64_t size; ///< Size of the file in bytes
+    std::int64_t time; ///< Last write time of the file in ticks of std::filesystem::file_time_type
+    std::uint64_t hash; ///< checksum() of the content of the file
+
+    auto operator==(const SourceStamp&) const -> bool = default;
+};
+
+/// \brief Start of the binary cache
+struct CacheHeader {
+    std::array<char, 8> magic; ///< cacheMagic
+    std::uint32_t version; ///< cacheVersion
+    std::uint32_t byteOrder; ///< cacheByteOrder
+    SourceStamp source; ///< The text file the cache was created from
+    std::uint64_t checksum; ///< checksum() of everything after the header
+    std::uint64_t sections; ///< Number of CacheSection records
+    std::uint64_t entries; ///< Number of CacheEntry records
+    std::uint64_t strings; ///< Size of the string table
+    std::uint64_t endsWithNewline; ///< Whether the text file ends with a line break
+};
+
+/// \brief Record of a Section in the binary cache
+struct CacheSection {
+    std::uint64_t title; ///< Offset of the title in the string table
+    std::uint64_t titleLength; ///< Length of the title
+    std::uint64_t parent; ///< Index of the parent Section plus one, 0 for a top-level Section
+    std::uint64_t start; ///< Position of the title in the text file
+    std::uint64_t end; ///< Position after the last line of the Section in the text file
+    std::uint64_t entries; ///< Number of entries of the Section
+};
+
+/// \brief Record of an Entry in the binary cache
+struct CacheEntry {
+    std::uint64_t key; ///< Offset of the key in the string table
+    std::uint64_t keyLength; ///< Length of the key
+    std::uint64_t value; ///< Offset of the value in the string table
+    std::uint64_t valueLength; ///< Length of the value
+    std::uint64_t offset; ///< Position of the value in the text file relative to its Section
+};
+
+/// \param filename The name of the text file.
+/// \returns The name of its binary cache.
+inline auto cacheFilename(const std::string& filename) -> std::string
+{
+    return filename + ".cache";
+}
+
+/// \brief Fast non-cryptographic 64 bit checksum
+/// \details The data is processed in four independent lanes of 8 bytes, so large caches are verified at memory speed.
+auto checksum(std::string_view data) -> std::uint64_t;
+
+/// \brief Stamp of a text file
+/// \param filename The name of the text file.
+/// \param content The content of the text file.
+/// \throws std::filesystem::filesystem_error if the file does not exist.
+auto sourceStamp(const std::string& filename, std::string_view content) -> SourceStamp;
@@ -14,7 +14,9 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <cstring>
+#include <span>
 
 #include <cppIni/cppIni_c.h>
 #include <cppIni/cppIni.h>
@@ -45,21 +47,33 @@ void cppIni_set(void* const file, const char* const section, const char* const k
     static_cast<File*>(file)->set(section, key, value);
 }
 
+/// All values are set before the file is written, so the file is written only once.
+///
+/// \param[in] file A pointer to a File object
+/// \param[in] entries An array of the values to set
+/// \param[in] count The number of values in the array
+void cppIni_set_many(void* const file, const cppIni_entry* const entries, const size_t count)
+{
+    static_cast<File*>(file)->setMany(std::span{entries, count});
+}
+
 /// \param[in] file A pointer to a File object
 /// \param[in] section The name of the section to get
 /// \param[in] key The name of the key to get
-/// \param[out] out A buffer to store the value in
-/// \param[in] outSize The size of the buffer
+/// \param[out] out A buffer to store the value in, the value is truncated if it does not fit
+/// \param[in] outSize The size of the buffer including the terminating null character
 /// \return A pointer to the buffer
 const char* cppIni_gets(const void* const file, const char* const section, const char* const key, char* out, size_t outSize)
 {
-    const auto value = static_cast<const File*>(file)->get<std::string>(section, key);
+    const auto value = static_cast<const File*>(file)->get<std::string_view>(section, key);
 
-    if (value.empty()) {
+    if (value.empty() or outSize == 0) {
         return out;
     }
 
-    std::strncpy(out, value.data(), outSize);
+    const auto length = std::min(value.size(), outSize - 1);
+    std::memcpy(out, value.data(), length);
+    out[length] = '\0';
     return out;
 }
 
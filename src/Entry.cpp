@@ -22,8 +22,8 @@
 auto Entry::fqKey() const -> std::string
 {
     if (m_parent == nullptr) {
-        return m_key;
+        return std::string(key());
     }
 
-    return m_parent->fqTitle() + "." + m_key;
+    return std::string(m_parent->fqTitle()) + "." + std::string(key());
 }
@@ -0,0 +1,317 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/EntryMap.h>
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+/// \param resource The memory resource the entries and the lookup table are allocated from.
+EntryMap::EntryMap(std::pmr::memory_resource* resource)
+    : m_order(resource)
+    , m_slots(resource)
+    , m_chunks(resource)
+    , m_free(resource)
+{
+}
+
+/// \details Like a std::pmr container, the copy uses the default memory resource. The entries are copied in order into
+/// a single chunk.
+/// \param other The map to copy.
+EntryMap::EntryMap(const EntryMap& other)
+    : EntryMap()
+{
+    reserve(other.size());
+
+    for (const auto& [key, entry] : other) {
+        try_emplace(key, entry);
+    }
+}
+
+/// \details The chunks and the memory resource move with the map, so no Entry is moved or copied.
+/// \param other The map to move.
+EntryMap::EntryMap(EntryMap&& other) noexcept
+    : m_order(std::move(other.m_order))
+    , m_slots(std::move(other.m_slots))
+    , m_chunks(std::move(other.m_chunks))
+    , m_free(std::move(other.m_free))
+{
+}
+
+EntryMap::~EntryMap()
+{
+    release();
+}
+
+/// \param other The map to copy.
+/// \returns This map.
+auto EntryMap::operator=(const EntryMap& other) -> EntryMap&
+{
+    auto copy = other;
+    swap(copy);
+    return *this;
+}
+
+/// \details The entries of this map are destroyed. This map takes over the chunks and the memory resource of the other
+/// one, so no Entry is moved or copied.
+/// \param other The map to move.
+/// \returns This map.
+auto EntryMap::operator=(EntryMap&& other) noexcept -> EntryMap&
+{
+    if (this != &other) {
+        release();
+        m_order = std::move(other.m_order);
+        m_slots = std::move(other.m_slots);
+        m_chunks = std::move(other.m_chunks);
+        m_free = std::move(other.m_free);
+    }
+
+    return *this;
+}
+
+/// \param other The map to exchange the entries with.
+auto EntryMap::swap(EntryMap& other) noexcept -> void
+{
+    m_order.swap(other.m_order);
+    m_slots.swap(other.m_slots);
+    m_chunks.swap(other.m_chunks);
+    m_free.swap(other.m_free);
+}
+
+/// \param key The key of the Entry to find.
+/// \returns An iterator to the key and the Entry, or end() if the key does not exist.
+auto EntryMap::find(std::string_view key) -> iterator
+{
+    const auto found = std::as_const(*this).find(key);
+    return begin() + (found - cbegin());
+}
+
+/// \param key The key of the Entry to find.
+/// \returns An iterator to the key and the Entry, or end() if the key does not exist.
+auto EntryMap::find(std::string_view key) const -> const_iterator
+{
+    if (m_order.empty()) {
+        return cend();
+    }
+
+    const auto slot = m_slots[probe(key, std::hash<std::string_view>{}(key))];
+    return slot.index == 0 ? cend() : cbegin() + (slot.index - 1);
+}
+
+/// \details Like find(), but for callers that need the Entry and not its position.
+/// \param key The key of the Entry to find.
+/// \returns The Entry, or nullptr if the key does not exist.
+auto EntryMap::get(std::string_view key) -> Entry*
+{
+    return const_cast<Entry*>(std::as_const(*this).get(key));
+}
+
+/// \details Like find(), but for callers that need the Entry and not its position.
+/// \param key The key of the Entry to find.
+/// \returns The Entry, or nullptr if the key does not exist.
+auto EntryMap::get(std::string_view key) const -> const Entry*
+{
+    if (m_order.empty()) {
+        return nullptr;
+    }
+
+    const auto slot = m_slots[probe(key, std::hash<std::string_view>{}(key))];
+    return slot.index == 0 ? nullptr : &m_order[slot.index - 1]->second;
+}
+
+/// \param key The key of the Entry.
+/// \returns The Entry with the key.
+/// \throws std::out_of_range if the key does not exist.
+auto EntryMap::at(std::string_view key) -> Entry&
+{
+    return const_cast<Entry&>(std::as_const(*this).at(key));
+}
+
+/// \param key The key of the Entry.
+/// \returns The Entry with the key.
+/// \throws std::out_of_range if the key does not exist.
+auto EntryMap::at(std::string_view key) const -> const Entry&
+{
+    if (const auto entry = get(key)) {
+        return *entry;
+    }
+
+    throw std::out_of_range{"No entry with key " + std::string(key)};
+}
+
+/// \details The lookup table is grown first if it would become more than half full.
+/// \param key The key that is about to be inserted.
+/// \returns The slot of the key or of the empty slot where it belongs and the hash of the key.
+auto EntryMap::prepare(std::string_view key) -> std::pair<std::size_t, std::size_t>
+{
+    if ((m_order.size() + 1) * 2 > m_slots.size()) {
+        rehash(std::max<std::size_t>(16, m_slots.size() * 2));
+    }
+
+    const auto hash = std::hash<std::string_view>{}(key);
+    return {probe(key, hash), hash};
+}
+
+/// \details The entries behind the removed one move forward in the order to keep it, but keep their address. The
+/// storage of the removed Entry is reused by the next insertion and the lookup table is rebuilt.
+/// \param key The key of the Entry to remove.
+/// \returns The number of removed entries, 0 or 1.
+auto EntryMap::erase(std::string_view key) -> std::size_t
+{
+    const auto position = find(key);
+
+    if (position == end()) {
+        return 0;
+    }
+
+    const auto index = position - begin();
+    const auto storage = m_order[static_cast<std::size_t>(index)];
+
+    m_free.reserve(m_free.size() + 1);
+    std::destroy_at(storage);
+    m_free.push_back(storage);
+    m_order.erase(m_order.begin() + index);
+    rehash(m_slots.size());
+
+    return 1;
+}
+
+/// \param size The number of entries to make room for.
+auto EntryMap::reserve(std::size_t size) -> void
+{
+    m_order.reserve(size);
+
+    const auto spare = m_free.size() + (m_chunks.empty() ? 0 : m_chunks.back().capacity - m_chunks.back().used);
+    if (size > m_order.size() + spare) {
+        grow(size - m_order.size() - spare);
+    }
+
+    if (size * 2 > m_slots.size()) {
+        rehash(std::bit_ceil(size * 2));
+    }
+}
+
+/// \details Storage of removed entries is reused first, so a map that changes keeps its size. Otherwise the next entry
+/// of the last chunk is used. The chunks grow with the map, so the number of allocations is logarithmic in its size.
+/// \returns Uninitialized storage for one Entry.
+auto EntryMap::allocate() -> value_type*
+{
+    if (not m_free.empty()) {
+        const auto storage = m_free.back();
+        m_free.pop_back();
+        return storage;
+    }
+
+    if (m_chunks.empty() or m_chunks.back().used == m_chunks.back().capacity) {
+        grow(std::max<std::size_t>(4, m_order.size()));
+    }
+
+    auto& chunk = m_chunks.back();
+    return chunk.data + chunk.used++;
+}
+
+/// \param storage Storage that was returned by the last call of allocate() and does not hold an Entry.
+auto EntryMap::deallocate(value_type* storage) noexcept -> void
+{
+    if (auto& chunk = m_chunks.back(); storage == chunk.data + chunk.used - 1) {
+        --chunk.used;
+    } else {
+        // It was taken from m_free, so there is room for it
+        m_free.push_back(storage);
+    }
+}
+
+/// \details The unused rest of the previous last chunk is handed out before the new chunk, so no storage is lost.
+/// \param capacity The number of entries the new chunk has room for.
+auto EntryMap::grow(std::size_t capacity) -> void
+{
+    m_chunks.reserve(m_chunks.size() + 1);
+
+    if (not m_chunks.empty()) {
+        auto& last = m_chunks.back();
+        m_free.reserve(m_free.size() + last.capacity - last.used);
+
+        // Reversed, because m_free is used from the back
+        for (auto storage = last.data + last.capacity; storage != last.data + last.used;) {
+            m_free.push_back(--storage);
+        }
+
+        last.used = last.capacity;
+    }
+
+    const auto data = static_cast<value_type*>(resource()->allocate(capacity * sizeof(value_type), alignof(value_type)));
+    m_chunks.push_back({data, capacity, 0});
+}
+
+/// \details Leaves the map without entries and without chunks. The memory resource is kept.
+auto EntryMap::release() noexcept -> void
+{
+    for (const auto entry : m_order) {
+        std::destroy_at(entry);
+    }
+
+    for (const auto& chunk : m_chunks) {
+        resource()->deallocate(chunk.data, chunk.capacity * sizeof(value_type), alignof(value_type));
+    }
+
+    m_order.clear();
+    m_slots.clear();
+    m_chunks.clear();
+    m_free.clear();
+}
+
+/// \details The table is probed linearly. Its size is a power of two and it is at most half full, so the probe
+/// sequence is short and always ends at an empty slot. The hash fragment is compared before the key.
+/// \param key The key to find.
+/// \param hash The hash of the key.
+/// \returns The index of the slot holding the key or of the empty slot where it would be inserted.
+auto EntryMap::probe(std::string_view key, std::size_t hash) const -> std::size_t
+{
+    const auto mask = m_slots.size() - 1;
+    const auto hashFragment = fragment(hash);
+
+    for (auto position = hash & mask;; position = (position + 1) & mask) {
+        const auto& slot = m_slots[position];
+
+        if (slot.index == 0 or (slot.hash == hashFragment and m_order[slot.index - 1]->first == key)) {
+            return position;
+        }
+    }
+}
+
+/// \param slots The new number of slots. It has to be a power of two.
+auto EntryMap::rehash(std::size_t slots) -> void
+{
+    m_slots.assign(slots, Slot{0, 0});
+
+    for (std::size_t i = 0; i < m_order.size(); ++i) {
+        const auto hash = std::hash<std::string_view>{}(m_order[i]->first);
+        m_slots[probe(m_order[i]->first, hash)] = {fragment(hash), static_cast<std::uint32_t>(i + 1)};
+    }
+}
+
+/// \details The lower bits of the hash select the slot, so the upper bits are stored to tell keys apart.
+/// \param hash The hash of a key.
+/// \returns The upper 32 bits of a 64-bit hash or 0 on platforms with a 32-bit std::size_t.
+auto EntryMap::fragment(std::size_t hash) -> std::uint32_t
+{
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>(hash) >> 32);
+}
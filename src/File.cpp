@@ -18,147 +18,1692 @@
 
 #include <cppIni/File.h>
 
+#include "AtomicFile.h"
+#include "BinaryCache.h"
+#include "FileWatcher.h"
+#include "LineScanner.h"
+#include "MappedFile.h"
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+/// \brief Locks that make a File safe to use from several threads
+/// \details The entries of the Sections are guarded by a fixed number of shards, so a writer only blocks readers and
+/// writers of the Sections in its shard. Writers hold the lock of the Sections shared while they change an Entry, so
+/// flushing, which only changes positions that readers never look at, locks it exclusively to wait for them. Locks are
+/// always taken in the order sections, shards, changes.
+struct File::Locks {
+    static constexpr std::size_t shardCount = 64;
+
+    /// \brief Lock on its own cache line, so threads using different shards do not slow each other down
+    /// \details Readers write to the cache line anyway when they lock it, so their lookups are counted here as well.
+    struct alignas(64) Shard {
+        std::shared_mutex mutex;
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+    };
+
+    std::shared_mutex sections; ///< Guards m_sections, m_index and the positions of the Sections and entries
+    std::array<Shard, shardCount> shards; ///< Guard the entries of the Sections
+    std::mutex changes; ///< Guards m_changed, m_watcher and the flags that decide how the next flush writes the file
+
+    /// \details The Sections are allocated next to each other, so their addresses are scrambled with a multiplicative
+    /// hash before they are mapped to a shard.
+    auto shard(const Section* section) -> std::shared_mutex&
+    {
+        return shardOf(section).mutex;
+    }
+
+    auto shardOf(const Section* section) -> Shard&
+    {
+        constexpr auto bits = std::bit_width(shardCount - 1);
+        const auto hash = reinterpret_cast<std::uintptr_t>(section) * std::uint64_t{0x9e3779b97f4a7c15};
+        return shards[static_cast<std::size_t>(hash >> (64 - bits))];
+    }
+};
+
+/// \brief Arena that can be used from several threads
+/// \details Deallocation does nothing in a monotonic arena, so only allocation has to be serialized.
+class SynchronizedArena final : public std::pmr::monotonic_buffer_resource {
+public:
+    using std::pmr::monotonic_buffer_resource::monotonic_buffer_resource;
+
+protected:
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override
+    {
+        const std::lock_guard lock{m_mutex};
+        return std::pmr::monotonic_buffer_resource::do_allocate(bytes, alignment);
+    }
+
+private:
+    std::mutex m_mutex;
+};
+
+/// \param filename The file whose size is used as the initial size of the arena.
+/// \param synchronized Whether the arena is used from several threads.
+/// \returns A new arena.
+static auto makeArena(const std::string& filename, bool synchronized) -> std::shared_ptr<std::pmr::monotonic_buffer_resource>
+{
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(filename, error);
+    const auto size = std::max<std::size_t>(error ? 0 : fileSize, 4096);
+
+    if (synchronized) {
+        return std::make_shared<SynchronizedArena>(size);
+    }
 
+    return std::make_shared<std::pmr::monotonic_buffer_resource>(size);
+}
+
+/// \param start The time an operation started.
+/// \returns The nanoseconds since then.
+static auto nanosecondsSince(std::chrono::steady_clock::time_point start) -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/// \param arena The arena the pool is allocated from. It is kept alive as long as the pool exists.
+/// \returns A new StringPool.
+static auto makePool(std::shared_ptr<std::pmr::monotonic_buffer_resource> arena) -> std::shared_ptr<StringPool>
+{
+    const auto resource = arena.get();
+    return {new StringPool{32, resource}, [arena = std::move(arena)](StringPool* pool) { delete pool; }};
+}
+
+/// \details With OpenOptions::arena, the arena starts with the size of the file, so a file is usually loaded with only a
+/// few allocations. A private StringPool takes its memory from the arena as well and keeps it alive. A thread-safe File
+/// creates its locks before the file is read.
 /// \param filename The filename of the file to open.
-File::File(std::string_view filename)
-: m_filename{filename}
+/// \param options The options used to read the file.
+File::File(std::string_view filename, OpenOptions options)
+: File{filename, std::move(options), Unopened{}}
 {
     open();
 }
 
+/// \param filename The filename of the file, empty if the File is read from memory.
+/// \param options The options used to read the file.
+File::File(std::string_view filename, OpenOptions options, Unopened)
+: m_filename{filename}
+, m_options{std::move(options)}
+, m_arena{m_options.arena ? makeArena(m_filename, m_options.threadSafe) : nullptr}
+, m_sectionStorage{std::make_unique<std::pmr::unsynchronized_pool_resource>(m_arena ? m_arena.get() : std::pmr::get_default_resource())}
+, m_pool{m_options.stringPool ? m_options.stringPool : m_arena ? makePool(m_arena) : std::make_shared<StringPool>()}
+, m_index{m_arena ? m_arena.get() : std::pmr::get_default_resource()}
+, m_locks{m_options.threadSafe ? std::make_unique<Locks>() : nullptr}
+{
+}
+
+/// \details The text is parsed like a mapped file. The load mode only decides whether Sections are parsed lazily.
+/// \param content The text to parse.
+/// \param owner The storage of the text if the File owns it, empty if the caller keeps it alive.
+/// \param options The options used to read the text.
+File::File(std::string_view content, std::shared_ptr<const std::string> owner, OpenOptions options)
+: File{{}, std::move(options), Unopened{}}
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    m_buffer = std::move(owner);
+    parseBuffer(content);
+
+    count(m_counters.loads);
+    count(m_counters.loadTime, nanosecondsSince(start));
+}
+
+/// \details The members are moved one by one, because the counters are atomic. The Sections are not moved, only the
+/// ownership of them, so pointers to them stay valid. The moved-from File has no Sections and may only be destroyed
+/// or assigned to.
+/// \param other The File to move.
+File::File(File&& other) noexcept
+: m_filename{std::move(other.m_filename)}
+, m_options{std::move(other.m_options)}
+, m_arena{std::move(other.m_arena)}
+, m_sectionStorage{std::move(other.m_sectionStorage)}
+, m_pool{std::move(other.m_pool)}
+, m_storage{std::move(other.m_storage)}
+, m_sections{std::move(other.m_sections)}
+, m_index{std::move(other.m_index)}
+, m_mapping{std::move(other.m_mapping)}
+, m_image{std::move(other.m_image)}
+, m_buffer{std::move(other.m_buffer)}
+, m_locks{std::move(other.m_locks)}
+, m_watcher{std::move(other.m_watcher)}
+, m_changed{std::move(other.m_changed)}
+, m_writtenSections{other.m_writtenSections}
+, m_unparsed{other.m_unparsed.load(std::memory_order_relaxed)}
+, m_generation{other.m_generation.load(std::memory_order_relaxed)}
+, m_counters{other.m_counters}
+, m_fileSize{other.m_fileSize}
+, m_fileTime{other.m_fileTime}
+, m_endsWithNewline{other.m_endsWithNewline}
+, m_patchable{other.m_patchable}
+, m_borrowing{other.m_borrowing}
+{
+}
+
+/// \details The memory of the Sections is released at once. Sections in an arena are only destroyed one by one if an
+/// Entry may own its text, which is the case after a Section was handed out by getSection().
 File::~File()
 {
-    for (auto& section : m_sections) {
-        delete section;
+    if (m_arena and m_borrowing) {
+        for (auto& section : m_storage) {
+            section.release();
+        }
+    }
+}
+
+/// \details The previous contents of this File are moved into a temporary File, whose destructor destroys the Sections
+/// before the storage they were allocated from. The members are then moved one by one like in the move constructor.
+/// The other File is left in the same state as by the move constructor.
+/// \param other The File to move.
+/// \returns This File.
+auto File::operator=(File&& other) noexcept -> File&
+{
+    if (this != &other) {
+        auto previous = File{std::move(*this)};
+
+        m_filename = std::move(other.m_filename);
+        m_options = std::move(other.m_options);
+        m_arena = std::move(other.m_arena);
+        m_sectionStorage = std::move(other.m_sectionStorage);
+        m_pool = std::move(other.m_pool);
+        m_storage = std::move(other.m_storage);
+        m_sections = std::move(other.m_sections);
+        // A polymorphic allocator stays with its container on assignment, so the index is constructed again to take
+        // over the nodes and the allocator of the other index
+        std::destroy_at(&m_index);
+        std::construct_at(&m_index, std::move(other.m_index));
+        m_mapping = std::move(other.m_mapping);
+        m_image = std::move(other.m_image);
+        m_buffer = std::move(other.m_buffer);
+        m_locks = std::move(other.m_locks);
+        m_watcher = std::move(other.m_watcher);
+        m_changed = std::move(other.m_changed);
+        m_writtenSections = other.m_writtenSections;
+        m_unparsed.store(other.m_unparsed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_generation.store(other.m_generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_counters = other.m_counters;
+        m_fileSize = other.m_fileSize;
+        m_fileTime = other.m_fileTime;
+        m_endsWithNewline = other.m_endsWithNewline;
+        m_patchable = other.m_patchable;
+        m_borrowing = other.m_borrowing;
     }
 
-    m_sections.clear();
+    return *this;
+}
+
+/// \param other The counters to copy.
+File::Counters::Counters(const Counters& other) noexcept
+: bytesParsed{other.bytesParsed.load(std::memory_order_relaxed)}
+, lines{other.lines.load(std::memory_order_relaxed)}
+, loads{other.loads.load(std::memory_order_relaxed)}
+, loadTime{other.loadTime.load(std::memory_order_relaxed)}
+, flushes{other.flushes.load(std::memory_order_relaxed)}
+, autoFlushes{other.autoFlushes.load(std::memory_order_relaxed)}
+, flushTime{other.flushTime.load(std::memory_order_relaxed)}
+, hits{other.hits.load(std::memory_order_relaxed)}
+, misses{other.misses.load(std::memory_order_relaxed)}
+{
+}
+
+/// \param other The counters to copy.
+/// \returns These counters.
+auto File::Counters::operator=(const Counters& other) noexcept -> Counters&
+{
+    bytesParsed.store(other.bytesParsed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    lines.store(other.lines.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    loads.store(other.loads.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    loadTime.store(other.loadTime.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    flushes.store(other.flushes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    autoFlushes.store(other.autoFlushes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    flushTime.store(other.flushTime.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    hits.store(other.hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    misses.store(other.misses.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    return *this;
 }
 
 /// \param filename The filename of the file to open.
-File File::open(std::string_view filename)
+/// \param options The options used to read the file.
+File File::open(std::string_view filename, OpenOptions options)
 {
-    return File{filename};
+    return File{filename, std::move(options)};
 }
 
+/// \details Keys and values are views into the text, so nothing is copied. The caller has to keep the text alive and
+/// unchanged as long as the File exists, with LoadMode::Lazy also because Sections are parsed when they are first used.
+/// \param content The text to parse.
+/// \param options The options used to read the text.
+/// \returns The File.
+auto File::fromBuffer(std::string_view content, OpenOptions options) -> File
+{
+    return File{content, nullptr, std::move(options)};
+}
+
+/// \see fromBuffer(std::string_view, OpenOptions)
+/// \param content The bytes to parse.
+/// \param options The options used to read the bytes.
+/// \returns The File.
+auto File::fromBuffer(std::span<const char> content, OpenOptions options) -> File
+{
+    return fromBuffer(std::string_view{content.data(), content.size()}, std::move(options));
+}
+
+/// \details The File keeps the string and borrows keys and values from it like fromBuffer() does, so a moved string
+/// is not copied at all.
+/// \param content The text to parse.
+/// \param options The options used to read the text.
+/// \returns The File.
+auto File::fromString(std::string content, OpenOptions options) -> File
+{
+    const auto owner = std::make_shared<const std::string>(std::move(content));
+    return File{*owner, owner, std::move(options)};
+}
+
+/// \details The rest of the stream is read into a string that the File owns, see fromString().
+/// \param input The stream to read.
+/// \param options The options used to read the stream.
+/// \returns The File.
+auto File::fromStream(std::istream& input, OpenOptions options) -> File
+{
+    return fromString(std::string{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}}, std::move(options));
+}
+
+/// \details With OpenOptions::cache, a valid binary cache is loaded instead of parsing the file. Otherwise the file is
+/// parsed and the cache is written for the next time. The cache only saves time, so failing to write it is ignored.
+/// With OpenOptions::watch, the file is watched before it is read, so no change is missed. A File that already has
+/// Sections is reloaded instead of reading the file into it a second time.
 /// \throws std::runtime_error if the file cannot be opened.
+/// \throws std::system_error if the file cannot be watched.
 void File::open()
 {
     if (m_filename.empty()) {
         throw std::runtime_error{"Filename is empty"};
     }
 
-    parse();
+    if (not m_sections.empty()) {
+        reload();
+        return;
+    }
+
+    if (m_options.watch and not m_watcher) {
+        m_watcher = std::make_unique<FileWatcher>(m_filename);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto cached = m_options.cache and loadCache();
+
+    if (not cached) {
+        parse();
+    }
+
+    count(m_counters.loads);
+    count(m_counters.loadTime, nanosecondsSince(start));
+
+    if (m_options.cache and not cached) {
+        try {
+            writeCache();
+        } catch (const std::system_error&) {
+        }
+    }
 }
 
+/// \details If every change since the last flush was made with set(), setMany() or a Batch and the file on disk still has
+/// the size it had when it was read or written last, only the changes are written. Otherwise the whole file is written.
+/// A thread-safe File waits for all writers and blocks new ones while it is written. Readers are not blocked.
 void File::flush()
 {
-    std::ofstream file{m_filename};
+    const auto lock = m_locks ? std::unique_lock{m_locks->sections} : std::unique_lock<std::shared_mutex>{};
+    const auto changes = m_locks ? std::unique_lock{m_locks->changes} : std::unique_lock<std::mutex>{};
+    const auto start = std::chrono::steady_clock::now();
 
-    for (const auto& section: m_sections) {
-        file << std::format("[{}]\n", section->fqTitle());
+    // A File read from memory has nothing to write to
+    if (not m_filename.empty()) {
+        std::error_code error;
+        const auto exists = std::filesystem::exists(m_filename, error);
 
-        for (const auto& [_, entry]: section->entries()) {
-            file << std::format("{}={}\n", entry.key(), entry.data());
+        // Positions are only known for the file as it was last read or written, so a file changed by someone else is
+        // written again even if its size did not change
+        if (m_patchable and exists and not changedOnDisk()) {
+            patch();
+        } else {
+            write();
         }
 
-        file << "\n";
+        // Remembered, so poll() does not mistake this flush for a change by someone else
+        m_fileTime = std::filesystem::last_write_time(m_filename, error);
     }
+
+    m_changed.clear();
+    m_patchable = true;
+
+    count(m_counters.flushes);
+    count(m_counters.flushTime, nanosecondsSince(start));
 }
 
-/// \details Scans the vector of Sections for the parent and creates the tree including the new Section if it does not exist.
-/// \param fqTitle The fully qualified title of the Section to create.
-/// \returns A pointer to the created Section.
-auto File::getSection(std::string_view fqTitle) -> Section*
+/// \details The cache holds all Sections and Entries together with their positions in the file, so a File loaded from it
+/// can still patch the file. It is replaced atomically, so Files that currently borrow from the old cache are not
+/// affected. The cache is named like the file with ".cache" appended.
+/// \throws std::logic_error if the File has changes that were not flushed yet.
+/// \throws std::system_error if the file does not exist, was changed since it was last read or written or the cache
+/// cannot be written.
+auto File::writeCache() const -> void
 {
-    if (const auto section = findSection(fqTitle); section) {
-        return const_cast<Section*>(section);
+    const auto lock = m_locks ? std::unique_lock{m_locks->sections} : std::unique_lock<std::shared_mutex>{};
+    const auto changes = m_locks ? std::unique_lock{m_locks->changes} : std::unique_lock<std::mutex>{};
+
+    if (m_filename.empty()) {
+        throw std::logic_error{"A File read from memory has no cache"};
     }
 
-    if (fqTitle.find('.') == std::string_view::npos) {
-        m_sections.emplace_back(new Section(fqTitle));
-        return m_sections.back();
-    } else {
-        const auto parent = getSection(fqTitle.substr(0, fqTitle.find_last_of('.')));
-        m_sections.emplace_back(new Section(fqTitle.substr(fqTitle.find_last_of('.') + 1), parent));
-        return m_sections.back();
+    if (not m_changed.empty() or not m_patchable) {
+        throw std::logic_error{"Changes have to be flushed before the cache of " + m_filename + " is written"};
+    }
+
+    const_cast<File*>(this)->loadAll();
+
+    const MappedFile source{m_filename};
+    const auto stamp = sourceStamp(m_filename, source.content());
+
+    // The stamp describes the file as it is now, so it must match the file that was parsed, also if someone else changed
+    // it without changing its size. Otherwise every later load would take the old Sections for the new file.
+    if (stamp.size != m_fileSize or stamp.time != m_fileTime.time_since_epoch().count()) {
+        throw std::system_error{std::make_error_code(std::errc::invalid_argument), m_filename + " was changed by someone else"};
+    }
+
+    std::unordered_map<const Section*, std::uint64_t> indices;
+    std::vector<CacheSection> sections;
+    std::vector<CacheEntry> entries;
+    std::string strings;
+
+    const auto store = [&strings](std::string_view text) {
+        strings.append(text);
+        return static_cast<std::uint64_t>(strings.size() - text.size());
+    };
+
+    sections.reserve(m_sections.size());
+    for (const auto section : m_sections) {
+        indices.emplace(section, sections.size());
+        sections.push_back({
+            store(section->title()), section->title().size(),
+            section->parent() ? indices.at(section->parent()) + 1 : 0,
+            section->m_start, section->m_end, section->entries().size(),
+        });
+
+        for (const auto& [key, entry] : section->entries()) {
+            entries.push_back({store(key), key.size(), store(entry.data()), entry.data().size(), entry.m_offset});
+        }
+    }
+
+    const auto sectionBytes = sections.size() * sizeof(CacheSection);
+    const auto entryBytes = entries.size() * sizeof(CacheEntry);
+    auto image = std::string(sizeof(CacheHeader) + sectionBytes + entryBytes, '\0');
+    std::memcpy(image.data() + sizeof(CacheHeader), sections.data(), sectionBytes);
+    std::memcpy(image.data() + sizeof(CacheHeader) + sectionBytes, entries.data(), entryBytes);
+    image.append(strings);
+
+    const CacheHeader header {
+        cacheMagic, cacheVersion, cacheByteOrder, stamp,
+        checksum(std::string_view{image}.substr(sizeof(CacheHeader))),
+        sections.size(), entries.size(), strings.size(), m_endsWithNewline,
+    };
+    std::memcpy(image.data(), &header, sizeof header);
+
+    replaceFile(cacheFilename(m_filename), image, false);
+}
+
+/// \details The file is read into a separate File first, so a thread-safe File can still be used while it is read.
+/// Then the changes are taken over with all locks held, see merge(). Changes that were not flushed are discarded.
+/// \note With LoadMode::Mapped, unchanged entries keep borrowing from the old mapping, so the file has to be replaced
+/// (as editors do when they save) instead of being rewritten in place.
+/// \throws std::runtime_error if the file cannot be read.
+auto File::reload() -> void
+{
+    if (m_filename.empty()) {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto options = OpenOptions{.loadMode = LoadMode::Mapped};
+    auto fresh = std::optional<File>{std::in_place, m_filename, options};
+
+    {
+        const auto lock = m_locks ? std::unique_lock{m_locks->sections} : std::unique_lock<std::shared_mutex>{};
+
+        // The file may have been changed again while it was read
+        if (fresh->changedOnDisk()) {
+            fresh.emplace(m_filename, options);
+        }
+
+        merge(*fresh);
+    }
+
+    count(m_counters.loads);
+    count(m_counters.loadTime, nanosecondsSince(start));
+    count(m_counters.bytesParsed, fresh->m_counters.bytesParsed);
+    count(m_counters.lines, fresh->m_counters.lines);
+
+    if (m_options.cache) {
+        try {
+            writeCache();
+        } catch (const std::system_error&) {
+        }
+    }
+}
+
+/// \details With OpenOptions::watch, the file is only looked at after the file system reported a change in its
+/// directory, so polling an unchanged file does not even access the disk. Otherwise the size and the write time of the
+/// file are compared on every call. Flushes of this File do not cause a reload.
+/// \returns true if the file was reloaded.
+auto File::poll() -> bool
+{
+    {
+        const auto changes = m_locks ? std::unique_lock{m_locks->changes} : std::unique_lock<std::mutex>{};
+
+        if (m_watcher and not m_watcher->changed()) {
+            return false;
+        }
+    }
+
+    {
+        const auto lock = m_locks ? std::shared_lock{m_locks->sections} : std::shared_lock<std::shared_mutex>{};
+
+        if (not changedOnDisk()) {
+            return false;
+        }
     }
+
+    reload();
+    return true;
+}
+
+/// \details reload() keeps the Sections it removes, because pointers to them and their entries may still be in use.
+/// compact() destroys them and gives their memory back for new Sections. Their entries are freed as well, unless they
+/// were allocated from an arena, which is only released with the File. Handles stay valid and look their Section up
+/// again.
+/// \returns The number of destroyed Sections.
+auto File::compact() -> std::size_t
+{
+    const auto lock = m_locks ? std::unique_lock{m_locks->sections} : std::unique_lock<std::shared_mutex>{};
+    const auto live = std::unordered_set<const Section*>{m_sections.begin(), m_sections.end()};
+
+    // Before any Section is destroyed, so a handle that still has one knows that it has to look it up again
+    m_generation.fetch_add(1, std::memory_order_release);
+
+    const auto [first, last] = std::ranges::stable_partition(m_storage, [&live](const auto& section) {
+        return live.contains(section.get());
+    });
+    const auto removed = static_cast<std::size_t>(last - first);
+
+    for (auto section = first; section != last; ++section) {
+        // Waits for readers that found the Section before the generation changed
+        const auto shard = m_locks ? std::unique_lock{m_locks->shard(section->get())} : std::unique_lock<std::shared_mutex>{};
+        const auto memory = section->release();
+        std::destroy_at(memory);
+        m_sectionStorage->deallocate(memory, sizeof(Section), alignof(Section));
+    }
+
+    m_storage.erase(first, last);
+
+    return removed;
+}
+
+/// \details The descriptor can be waited for with poll(), select() or an event loop, after which poll() reloads the
+/// file. Only Linux provides such a descriptor.
+/// \returns The descriptor or -1.
+auto File::watchHandle() const -> int
+{
+    return m_watcher ? m_watcher->handle() : -1;
+}
+
+/// \details A file that cannot be accessed is not considered changed, so the File keeps its content while an editor
+/// replaces the file.
+/// \returns true if the file has another size or write time than when it was last read or written.
+auto File::changedOnDisk() const -> bool
+{
+    std::error_code error;
+    const auto size = std::filesystem::file_size(m_filename, error);
+    if (error) {
+        return false;
+    }
+
+    const auto time = std::filesystem::last_write_time(m_filename, error);
+    return not error and (size != m_fileSize or time != m_fileTime);
+}
+
+/// \details Sections are matched by their fully qualified title, Sections with the same title in the order they
+/// appear. Matched Sections and their entries keep their address. Only values that differ are replaced, new entries and
+/// Sections are added and the positions of everything are updated. Entries that were removed from the file are erased,
+/// which does not move the other entries, so they keep their address as well. Sections that were removed from the file
+/// cannot be found anymore, but are kept alive for pointers that may still refer to them until compact() destroys them.
+/// \note Requires the exclusive lock of the Sections.
+/// \param fresh A File that was just read from the same file. Nothing is borrowed from it.
+auto File::merge(const File& fresh) -> void
+{
+    loadAll();
+
+    // Before any Section changes, so a KeyHandle that sees the old generation under the lock of a Section knows that
+    // the Section was not changed yet
+    m_generation.fetch_add(1, std::memory_order_release);
+
+    const auto own = [this](std::string_view text) -> Entry::Text {
+        if (m_arena) {
+            return copy(text);
+        }
+
+        return std::string{text};
+    };
+
+    // The Sections that have not been matched yet for every title, the next one at the back
+    std::unordered_map<std::string_view, std::vector<Section*>> remaining;
+    for (auto section = m_sections.rbegin(); section != m_sections.rend(); ++section) {
+        remaining[(*section)->fqTitle()].push_back(*section);
+    }
+
+    std::unordered_map<const Section*, Section*> matches;
+    m_sections.clear();
+    m_sections.reserve(fresh.m_sections.size());
+
+    for (const auto source : fresh.m_sections) {
+        auto target = static_cast<Section*>(nullptr);
+
+        if (const auto candidates = remaining.find(source->fqTitle()); candidates != remaining.end() and not candidates->second.empty()) {
+            target = candidates->second.back();
+            candidates->second.pop_back();
+            m_sections.push_back(target);
+        } else {
+            // Parents always precede their subsections
+            target = addSection(source->title(), source->parent() ? matches.at(source->parent()) : nullptr);
+        }
+
+        matches.emplace(source, target);
+        target->m_start = source->m_start;
+        target->m_end = source->m_end;
+
+        const auto lock = m_locks ? std::unique_lock{m_locks->shard(target)} : std::unique_lock<std::shared_mutex>{};
+
+        // Adding and removing entries does not move the other entries of the EntryMap, so unchanged ones keep their address
+        for (const auto& [key, entry] : source->m_entries) {
+            const auto position = target->m_entries.find(key);
+
+            if (position == target->m_entries.end()) {
+                auto added = Entry::borrow(m_pool->intern(key), {}, target);
+                added.m_data = own(entry.data());
+                added.m_offset = entry.m_offset;
+                added.m_length = entry.m_length;
+                target->addEntry(std::move(added));
+                continue;
+            }
+
+            auto& stored = position->second;
+
+            if (stored.data() != entry.data()) {
+                stored.m_data = own(entry.data());
+                stored.m_cache.clear();
+            }
+
+            stored.m_offset = entry.m_offset;
+            stored.m_length = entry.m_length;
+        }
+
+        // All at once, so the lookup table of the Section is rebuilt only once
+        if (target->m_entries.size() > source->m_entries.size()) {
+            target->m_entries.erase_if([source](const EntryMap::value_type& entry) {
+                return not source->m_entries.contains(entry.first);
+            });
+        }
+    }
+
+    for (const auto& [title, sections] : remaining) {
+        for (const auto section : sections) {
+            if (const auto indexed = m_index.find(title); indexed != m_index.end() and indexed->second == section) {
+                m_index.erase(indexed);
+            }
+
+            // The Section stays in m_storage until compact(), because it may still be referenced
+        }
+    }
+
+    m_fileSize = fresh.m_fileSize;
+    m_fileTime = fresh.m_fileTime;
+    m_endsWithNewline = fresh.m_endsWithNewline;
+    m_writtenSections = m_sections.size();
+
+    const auto changes = m_locks ? std::unique_lock{m_locks->changes} : std::unique_lock<std::mutex>{};
+    m_changed.clear();
+    m_patchable = true;
 }
 
-/// \param title The title of the Section to find.
+/// \details The Section is created if it does not exist.
+/// \note Changes made through the returned pointer cannot be tracked, so the next flush() writes the whole file.
+/// \param fqTitle The fully qualified title of the Section.
+/// \returns A pointer to the Section.
+/// \see set() for changing values without losing the layout of the file.
+auto File::getSection(std::string_view fqTitle) -> Section*
+{
+    {
+        const auto changes = m_locks ? std::unique_lock{m_locks->changes} : std::unique_lock<std::mutex>{};
+        m_patchable = false;
+        m_borrowing = false;
+    }
+
+    return makeSection(fqTitle);
+}
+
+/// \details Sections are never moved or destroyed before the File, so the returned pointer stays valid even if other
+/// threads create Sections. With LoadMode::Lazy, the entries of the Section are parsed before it is returned.
+/// \param title The fully qualified title of the Section to find.
 /// \returns A pointer to the Section if found, nullptr otherwise.
 auto File::findSection(std::string_view title) const -> const Section*
 {
-    const auto section = std::find_if(std::cbegin(m_sections), std::cend(m_sections), [&title](const auto& section) {
-        return section->fqTitle() == title;
-    });
+    const Section* found = nullptr;
 
-    if (section == std::cend(m_sections)) {
-        return nullptr;
+    {
+        const auto lock = m_locks ? std::shared_lock{m_locks->sections} : std::shared_lock<std::shared_mutex>{};
+
+        if (const auto section = m_index.find(title); section != m_index.cend()) {
+            found = section->second;
+        }
+    }
+
+    if (found and m_unparsed != 0) {
+        loadLocked(found);
     }
 
-    return *section;
+    return found;
 }
 
-/// \param name The name of the Entry to find.
+/// \details With LoadMode::Lazy, the entries of all Sections that were not looked up yet are parsed first.
+/// \returns The Sections in the order of the file, followed by the ones created later.
+auto File::sections() const -> const std::vector<Section*>&
+{
+    if (m_unparsed != 0) {
+        for (const auto section : m_sections) {
+            loadLocked(section);
+        }
+    }
+
+    return m_sections;
+}
+
+/// \param name The fully qualified name of the Entry to find (e.g. "Section1.Section2.Key").
 /// \returns A pointer to the Entry if found, nullptr otherwise.
 /// \see Section::findEntry
 auto File::findEntry(std::string_view name) const -> const Entry*
 {
-    const Section* section = nullptr;
+    const auto separator = name.find_last_of('.');
 
-    if (name.find('.')) {
-        section = findSection(name.substr(0, name.find_last_of('.')));
+    if (separator == std::string_view::npos) {
+        return nullptr;
     }
 
-    if (section) {
-        return section->findEntry(name.substr(name.find_last_of('.') + 1));
+    return findEntry(name.substr(0, separator), name.substr(separator + 1));
+}
+
+/// \details Unlike findEntry(std::string_view), the name of the Section and the Entry are passed separately, so they
+/// never have to be joined. The lookup does not allocate.
+/// \param section The fully qualified title of the Section to search in.
+/// \param name The name of the Entry to find.
+/// \returns A pointer to the Entry if found, nullptr otherwise.
+/// \see Section::findEntry
+auto File::findEntry(std::string_view section, std::string_view name) const -> const Entry*
+{
+    if (const auto s = findSection(section)) {
+        const auto lock = lockShared(s);
+        const auto entry = s->findEntry(name);
+        countLookup(s, entry != nullptr);
+        return entry;
     }
 
+    countLookup(nullptr, false);
     return nullptr;
 }
 
+/// \details The title is interned, so the handle does not depend on the lifetime of the argument.
+/// \param fqTitle The fully qualified title of the Section.
+/// \returns A handle that finds the Section without looking it up again.
+auto File::sectionHandle(std::string_view fqTitle) const -> SectionHandle
+{
+    auto handle = SectionHandle{this, m_pool->intern(fqTitle)};
+    handle.get();
+    return handle;
+}
+
+/// \details The Section and the key are looked up once here. Afterwards the handle only looks them up again after a
+/// reload or while the key does not exist.
+/// \param section The fully qualified title of the Section.
+/// \param key The key of the Entry.
+/// \returns A handle that reads the Entry without looking it up again.
+auto File::keyHandle(std::string_view section, std::string_view key) const -> KeyHandle
+{
+    return sectionHandle(section).key(key);
+}
+
+/// \param section The Section whose entries are read.
+/// \returns A lock that has to be held while the entries are read.
+auto File::lockShared(const Section* section) const -> std::shared_lock<std::shared_mutex>
+{
+    return m_locks ? std::shared_lock{m_locks->shard(section)} : std::shared_lock<std::shared_mutex>{};
+}
+
+/// \details A thread-safe File counts the lookups of a Section in its shard. The reader has just written the cache line of
+/// the shard by locking it, so readers of different Sections do not contend for a counter.
+/// \param section The Section that was searched, nullptr if it does not exist.
+/// \param found Whether the Entry was found.
+auto File::countLookup(const Section* section, bool found) const -> void
+{
+    if constexpr (statisticsEnabled) {
+        if (m_locks and section) {
+            auto& shard = m_locks->shardOf(section);
+            count(found ? shard.hits : shard.misses);
+        } else {
+            count(found ? m_counters.hits : m_counters.misses);
+        }
+    }
+}
+
+/// \details The counters are read without synchronization, so they may miss what other threads do at the same time.
+/// The Sections, the entries and the heap memory are counted by visiting all Sections, which takes their locks in a
+/// thread-safe File but does not parse lazily loaded Sections. The heap memory is estimated from the sizes of the
+/// containers, the text owned by the entries and the StringPool, which is included even if it is shared.
+/// \returns The counters of the File.
+auto File::stats() const -> FileStats
+{
+    const auto load = [](const std::atomic<std::uint64_t>& counter) { return counter.load(std::memory_order_relaxed); };
+    const auto owned = [](const Entry::Text& text) -> std::uint64_t {
+        // Short strings are stored inside the Entry
+        const auto string = std::get_if<std::string>(&text);
+        return string and string->capacity() > std::string{}.capacity() ? string->capacity() + 1 : 0;
+    };
+
+    auto stats = FileStats{
+        .bytesParsed = load(m_counters.bytesParsed),
+        .lines = load(m_counters.lines),
+        .loads = load(m_counters.loads),
+        .loadTime = std::chrono::nanoseconds{load(m_counters.loadTime)},
+        .flushes = load(m_counters.flushes),
+        .autoFlushes = load(m_counters.autoFlushes),
+        .flushTime = std::chrono::nanoseconds{load(m_counters.flushTime)},
+        .hits = load(m_counters.hits),
+        .misses = load(m_counters.misses),
+    };
+
+    if (m_locks) {
+        for (const auto& shard : m_locks->shards) {
+            stats.hits += load(shard.hits);
+            stats.misses += load(shard.misses);
+        }
+    }
+
+    const auto lock = m_locks ? std::shared_lock{m_locks->sections} : std::shared_lock<std::shared_mutex>{};
+
+    stats.sections = m_sections.size();
+    stats.heapBytes = sizeof(File) + m_pool->capacity()
+                      + (m_sections.capacity() + m_storage.capacity()) * sizeof(Section*)
+                      + m_index.size() * (sizeof(decltype(m_index)::value_type) + 2 * sizeof(void*))
+                      + m_changed.capacity() * sizeof(decltype(m_changed)::value_type);
+
+    // Every Section is visited, also those removed by a reload, but only the entries of the File are counted
+    for (const auto& section : m_storage) {
+        const auto shard = lockShared(section.get());
+        stats.heapBytes += sizeof(Section) + section->entries().size() * (sizeof(EntryMap::value_type) + sizeof(EntryMap::value_type*));
+
+        for (const auto& [_, entry] : section->entries()) {
+            stats.heapBytes += owned(entry.m_key) + owned(entry.m_data);
+        }
+    }
+
+    for (const auto section : m_sections) {
+        const auto shard = lockShared(section);
+        stats.entries += section->entries().size();
+    }
+
+    return stats;
+}
+
+/// \details The snapshot copies the current content of the File. Later changes to the File are not visible in it.
+/// \returns A FrozenFile with all Sections and Entries of this File.
+/// \see FrozenFile
+auto File::freeze() const -> FrozenFile
+{
+    const auto lock = m_locks ? std::unique_lock{m_locks->sections} : std::unique_lock<std::shared_mutex>{};
+    const_cast<File*>(this)->loadAll();
+
+    return FrozenFile{*this};
+}
+
 auto File::operator==(const File& other) const -> bool
 {
+    const_cast<File*>(this)->loadAll();
+    const_cast<File&>(other).loadAll();
+
     return std::equal(std::cbegin(m_sections), std::cend(m_sections), std::cbegin(other.m_sections), std::cend(other.m_sections), [](const auto& lhs, const auto& rhs) {
         return *lhs == *rhs;
     });
 }
 
+/// \brief Builds the Sections and entries reported by a Parser
+struct File::Reader {
+    File& file;
+    bool borrow; ///< Whether the entries reference the lines instead of copying them
+
+    auto section(const ParsedSection& parsed) -> void { file.parseSection(parsed); }
+
+    auto entry(const ParsedEntry& parsed) -> void
+    {
+        // Lines in front of the first title do not belong to any Section
+        if (not file.m_sections.empty()) {
+            file.parseEntry(*file.m_sections.back(), parsed, borrow);
+        }
+    }
+};
+
+/// \brief A change to the file on disk
+struct File::Patch {
+    std::size_t offset; ///< Position of the replaced text in the file
+    std::size_t length; ///< Length of the replaced text
+    std::string text{}; ///< Text written instead
+    std::vector<std::tuple<Entry*, const Section*, std::size_t>> entries{}; ///< Entries written by this patch, their Sections and the positions of their values in text
+    std::vector<std::tuple<Section*, std::size_t, std::size_t>> sections{}; ///< Sections written by this patch and their starts and ends in text
+
+    auto appendSection(Section& section) -> void; ///< Append a Section with all its entries to text
+    auto place(std::size_t position) const -> void; ///< Update the layout after text was written at position
+};
+
+/// \param section The Section to append.
+auto File::Patch::appendSection(Section& section) -> void
+{
+    const auto start = text.size();
+    text.append("[").append(section.fqTitle()).append("]\n");
+
+    for (auto& [key, entry]: section.m_entries) {
+        text.append(key).append("=");
+        entries.emplace_back(&entry, &section, text.size());
+        text.append(entry.data()).append("\n");
+    }
+
+    sections.emplace_back(&section, start, text.size());
+    text.append("\n");
+}
+
+/// \param position The position of text in the file.
+auto File::Patch::place(std::size_t position) const -> void
+{
+    for (const auto& [section, start, end]: sections) {
+        section->m_start = position + start;
+        section->m_end = position + end;
+    }
+
+    for (const auto& [entry, section, offset]: entries) {
+        entry->m_offset = position + offset - section->m_start;
+        entry->m_length = entry->data().size();
+    }
+}
+
 /// \details This function is called by the constructor. It should not be called directly.
+/// With LoadMode::Stream the file is read by a Parser, whose titles and entries are added by a Reader.
+/// With LoadMode::Mapped the whole file is mapped once and scanned in place. Keys and values are not copied but
+/// borrowed from the mapping, which is kept alive by this File. LoadMode::Lazy maps the file the same way, but only
+/// creates the Sections, see load().
 /// \throws std::runtime_error if the file cannot be opened.
 /// \see File::open for the public function.
 auto File::parse() -> void
 {
-    auto content = std::ifstream{m_filename};
+    // Taken before the file is read, so a change while it is read is noticed by poll()
+    std::error_code error;
+    m_fileTime = std::filesystem::last_write_time(m_filename, error);
+
+    if (m_options.loadMode != LoadMode::Stream) {
+        m_mapping = std::make_shared<const MappedFile>(m_filename);
+        parseBuffer(m_mapping->content());
+        return;
+    }
+
+    auto content = std::ifstream{m_filename, std::ios::binary};
+    auto parser = Parser{};
+
+    parser.parse(content, Reader{*this, false});
+    count(m_counters.lines, parser.lines());
+    finishParse(parser.offset(), parser.endsWithNewline());
+}
+
+/// \details Large texts are parsed on several threads, see parseChunks(). The text has to outlive the File.
+/// \param content The text to parse.
+auto File::parseBuffer(std::string_view content) -> void
+{
+    // Small chunks are not worth a thread
+    constexpr std::size_t minimumChunk = 256 * 1024;
+    const auto threads = std::min<std::size_t>(m_options.parseThreads == 0 ? std::thread::hardware_concurrency() : m_options.parseThreads,
+                                               content.size() / minimumChunk);
+
+    parseChunks(content, std::max<std::size_t>(threads, 1));
+
+    const auto newline = content.empty() or content.back() == '\n';
+
+    if constexpr (statisticsEnabled) {
+        count(m_counters.lines, static_cast<std::uint64_t>(std::ranges::count(content, '\n')) + not newline);
+    }
+
+    finishParse(content.size(), newline);
+}
+
+/// \param size The number of bytes that were parsed.
+/// \param newline Whether the text ends with a line break.
+auto File::finishParse(std::size_t size, bool newline) -> void
+{
+    m_fileSize = size;
+    m_endsWithNewline = newline;
+    m_writtenSections = m_sections.size();
+    count(m_counters.bytesParsed, size);
+    m_changed.clear();
+
+    if (not m_sections.empty()) {
+        m_sections.back()->m_end = std::min<std::size_t>(m_sections.back()->m_end, m_fileSize);
+    }
+}
+
+/// \details The cache is only used if it was written by this version of the library on a machine with the same byte
+/// order, is not damaged and the size, the write time and the content of the file are the ones it was created from.
+/// Checking the content reads the file, which is still much faster than parsing it. Keys and values are borrowed from
+/// the mapped cache, regardless of the LoadMode.
+/// \returns true if the File was loaded from the cache, false if it has to be parsed.
+auto File::loadCache() -> bool
+{
+    std::error_code error;
+    const auto size = std::filesystem::file_size(m_filename, error);
+    const auto time = std::filesystem::last_write_time(m_filename, error);
+    if (error) {
+        return false;
+    }
+
+    auto image = std::make_shared<const MappedFile>(cacheFilename(m_filename));
+    const auto content = image->content();
+
+    CacheHeader header;
+    if (content.size() < sizeof header) {
+        return false;
+    }
+    std::memcpy(&header, content.data(), sizeof header);
+
+    const auto payload = content.substr(sizeof header);
+    if (header.magic != cacheMagic or header.version != cacheVersion or header.byteOrder != cacheByteOrder
+        or header.source.size != size or header.source.time != time.time_since_epoch().count()
+        or header.sections > payload.size() / sizeof(CacheSection) or header.entries > payload.size() / sizeof(CacheEntry)
+        or header.sections * sizeof(CacheSection) + header.entries * sizeof(CacheEntry) + header.strings != payload.size()
+        or checksum(payload) != header.checksum or checksum(MappedFile{m_filename}.content()) != header.source.hash) {
+        return false;
+    }
+
+    const auto sections = payload.data();
+    const auto entries = sections + header.sections * sizeof(CacheSection);
+    const auto strings = payload.substr(payload.size() - header.strings);
+    const auto inStrings = [&strings](std::uint64_t offset, std::uint64_t length) {
+        return offset <= strings.size() and length <= strings.size() - offset;
+    };
+
+    // The checksum only detects damage, so every record is checked before it is used
+    const auto discard = [this] {
+        m_sections.clear();
+        m_storage.clear();
+        m_index.clear();
+        return false;
+    };
+
+    std::uint64_t entryCount = 0;
+    for (std::uint64_t i = 0; i < header.sections; ++i) {
+        CacheSection record;
+        std::memcpy(&record, sections + i * sizeof record, sizeof record);
+
+        if (not inStrings(record.title, record.titleLength) or record.parent > i or record.entries > header.entries - entryCount) {
+            return discard();
+        }
+
+        const auto section = addSection(strings.substr(record.title, record.titleLength), record.parent ? m_sections[record.parent - 1] : nullptr);
+        section->m_start = record.start;
+        section->m_end = record.end;
+        section->m_entries.reserve(record.entries);
+
+        for (const auto last = entryCount + record.entries; entryCount < last; ++entryCount) {
+            CacheEntry entry;
+            std::memcpy(&entry, entries + entryCount * sizeof entry, sizeof entry);
+
+            if (not inStrings(entry.key, entry.keyLength) or not inStrings(entry.value, entry.valueLength)) {
+                return discard();
+            }
+
+            auto borrowed = Entry::borrow(strings.substr(entry.key, entry.keyLength), strings.substr(entry.value, entry.valueLength), section);
+            borrowed.m_offset = entry.offset;
+            borrowed.m_length = entry.valueLength;
+            section->addEntry(std::move(borrowed));
+        }
+    }
+
+    if (entryCount != header.entries) {
+        return discard();
+    }
+
+    m_image = std::move(image);
+    m_fileSize = header.source.size;
+    m_fileTime = time;
+    m_endsWithNewline = header.endsWithNewline != 0;
+    m_writtenSections = m_sections.size();
+    m_changed.clear();
+
+    return true;
+}
+
+/// \details A relative title like [.Subsection] is added to the last Section. A title like [A.B] is added to the
+/// Section A if it exists and is a top-level Section named "A.B" otherwise. The position of the Section is recorded, so
+/// flush() can patch the file later.
+/// \param parsed The title line.
+auto File::parseSection(const ParsedSection& parsed) -> void
+{
+    auto title = parsed.title;
+    Section* parent = parsed.relative and not m_sections.empty() ? m_sections.back() : nullptr;
+
+    if (const auto dot = title.find_last_of('.'); not parsed.relative and dot != std::string_view::npos) {
+        if (const auto section = findSection(title.substr(0, dot)); section) {
+            parent = const_cast<Section*>(section);
+            title = title.substr(dot + 1);
+        }
+    }
+
+    const auto section = addSection(title, parent);
+    section->m_start = parsed.offset;
+    section->m_end = parsed.offset + parsed.line.size() + 1;
+}
+
+/// \details If a StringPool is shared with other Files, keys and values that are not longer than
+/// StringPool::maxValueLength() are interned so equal text is only stored once across all of them. With an arena, keys
+/// that are not borrowed are interned and values are copied into the arena.
+/// The position of the value and the end of the Section are recorded, so flush() can patch the file later. Only the
+/// Section is changed, so entries of different Sections can be parsed at the same time if they borrow from the line.
+/// \param section The Section the line belongs to.
+/// \param parsed The line. Its key and value have to be views into the line.
+/// \param borrow Whether the created Entry references the line instead of copying it.
+auto File::parseEntry(Section& section, const ParsedEntry& parsed, bool borrow) -> void
+{
+    const auto end = parsed.offset + parsed.line.size() + 1;
+    const auto position = parsed.offset + static_cast<std::size_t>(parsed.value.data() - parsed.line.data());
+    auto key = parsed.key;
+    auto value = parsed.value;
+    const auto length = value.size();
+
+    if (m_options.stringPool) {
+        key = m_pool->intern(key);
+
+        if (value.size() <= m_pool->maxValueLength()) {
+            value = m_pool->intern(value);
+            borrow = true;
+        }
+    }
+
+    if (m_arena and not borrow) {
+        key = m_pool->intern(key);
+        value = copy(value);
+        borrow = true;
+    }
+
+    auto entry = borrow ? Entry::borrow(key, value, &section) : Entry{key, value, &section};
+    entry.m_offset = position - section.m_start;
+    entry.m_length = length;
+
+    section.addEntry(std::move(entry));
+    section.m_end = end;
+}
+
+/// \details The content is split into one chunk per thread at lines that start a Section, so a Section and its entries
+/// always belong to a single chunk. First every thread finds the titles in its chunk. Then a single thread creates the
+/// Sections in the order of the file, because relative titles like [.Subsection] and parents like [A.B] depend on all
+/// Sections in front of them, and reserves room for their entries. Finally every thread parses the entries of its
+/// Sections. They borrow from the mapping, so the threads neither allocate nor share any state, unless
+/// OpenOptions::stringPool is set. Then every key and short value is interned, which allocates and makes the threads
+/// wait for each other on the lock of the pool, so only finding the lines runs fully in parallel.
+/// With LoadMode::Lazy, the threads only look for lines starting with '[' and the Sections keep their lines unparsed.
+/// \param content The mapped content of the file.
+/// \param threads The number of threads to use, including the calling one.
+/// \throws The first exception thrown while parsing.
+auto File::parseChunks(std::string_view content, std::size_t threads) -> void
+{
+    /// \brief A title line and the lines behind it
+    struct Block {
+        std::size_t offset; ///< Position of the title line
+        std::size_t lines; ///< Number of non-empty lines behind the title line
+        std::size_t end {0}; ///< Position after the last non-empty line, only found with LoadMode::Lazy
+        Section* section {nullptr};
+    };
+
+    const auto lazy = m_options.loadMode == LoadMode::Lazy;
+
+    const auto forEachLine = [content](std::size_t begin, std::size_t end, auto&& function) {
+        scanLines(content.substr(begin, end - begin), [begin, &function](std::string_view line, std::size_t offset, std::size_t separator) {
+            if (not line.empty()) {
+                function(line, begin + offset, separator);
+            }
+        });
+    };
+
+    auto bounds = std::vector<std::size_t>{0};
+    for (std::size_t i = 1; i < threads; ++i) {
+        const auto split = std::max(bounds.back(), content.size() * i / threads);
+        const auto title = content.find("\n[", split - 1);
+        bounds.push_back(title == std::string_view::npos ? content.size() : title + 1);
+    }
+    bounds.push_back(content.size());
+
+    auto chunks = std::vector<std::vector<Block>>(threads);
+    auto error = std::exception_ptr{};
+    auto errorMutex = std::mutex{};
+    auto failed = std::atomic<bool>{false};
+    const auto fail = [&] {
+        const std::lock_guard lock{errorMutex};
+        error = error ? error : std::current_exception();
+        failed = true;
+    };
+
+    // Runs on one thread while the others wait
+    const auto createSections = [&]() noexcept {
+        try {
+            auto parser = Parser{};
+
+            for (auto i = std::size_t{0}; not failed and i < threads; ++i) {
+                for (auto& block : chunks[i]) {
+                    parser.line(content.substr(block.offset, content.find('\n', block.offset) - block.offset), block.offset, Reader{*this, true});
+                    block.section = m_sections.back();
+
+                    if (lazy) {
+                        block.section->m_pending = content.substr(block.offset, block.end - block.offset);
+                        block.section->m_end = block.end;
+                        ++m_unparsed;
+                    } else {
+                        block.section->m_entries.reserve(block.lines);
+                    }
+                }
+            }
+        } catch (...) {
+            fail();
+        }
+    };
+
+    auto barrier = std::barrier{static_cast<std::ptrdiff_t>(threads), createSections};
+    const auto parseChunk = [&](std::size_t i) {
+        auto& blocks = chunks[i];
+
+        try {
+            if (lazy) {
+                findTitles(content, bounds[i], bounds[i + 1], [&blocks](std::size_t offset, std::size_t end) {
+                    blocks.push_back({offset, 0, end});
+                });
+            } else {
+                forEachLine(bounds[i], bounds[i + 1], [&blocks](std::string_view line, std::size_t offset, std::size_t) {
+                    if (line[0] == '[') {
+                        blocks.push_back({offset, 0});
+                    } else if (not blocks.empty()) {
+                        ++blocks.back().lines;
+                    }
+                });
+            }
+        } catch (...) {
+            fail();
+        }
+
+        barrier.arrive_and_wait();
+
+        if (lazy) {
+            return;
+        }
+
+        try {
+            auto block = blocks.begin();
+            forEachLine(bounds[i], bounds[i + 1], [&](std::string_view line, std::size_t offset, std::size_t separator) {
+                if (failed) {
+                    return;
+                }
+
+                if (line[0] == '[') {
+                    ++block;
+                } else if (block != blocks.begin()) {
+                    const auto section = std::prev(block)->section;
+                    parseEntry(*section, Parser::entry(section->fqTitle(), line, offset, separator), true);
+                }
+            });
+        } catch (...) {
+            fail();
+        }
+    };
+
+    {
+        auto workers = std::vector<std::jthread>{};
+        for (auto i = std::size_t{1}; i < threads; ++i) {
+            workers.emplace_back(parseChunk, i);
+        }
+
+        parseChunk(0);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/// \details The lines of the Section are taken from the mapping it was found in, which the File keeps alive even after
+/// a flush replaced the file. They cannot have changed, because setting a value looks the Section up first. Positions
+/// of entries are relative to their Section, so they are still right if a flush moved the Section.
+/// \param section The Section to parse.
+auto File::load(Section& section) -> void
+{
+    if (section.m_pending.data() == nullptr) {
+        return;
+    }
+
+    const auto lines = std::exchange(section.m_pending, {});
+    const auto end = section.m_end;
+    --m_unparsed;
+
+    scanLines(lines, [this, &section](std::string_view line, std::size_t offset, std::size_t separator) {
+        if (offset != 0 and not line.empty()) {
+            parseEntry(section, Parser::entry(section.fqTitle(), line, section.m_start + offset, separator), true);
+        }
+    });
+
+    // The end was found with the title and may have been cut to the size of the file
+    section.m_end = end;
+}
+
+auto File::loadAll() -> void
+{
+    if (m_unparsed != 0) {
+        for (const auto section : m_sections) {
+            load(*section);
+        }
+    }
+}
+
+/// \details A thread-safe File checks the Section with a shared lock first, so threads only wait for each other while
+/// the Section is actually parsed. The Sections are locked shared, so a flush cannot move the Section meanwhile.
+/// \param section The Section to parse.
+auto File::loadLocked(const Section* section) const -> void
+{
+    // Parsing adds entries to the Section, which is part of the content of the File rather than its state
+    const auto file = const_cast<File*>(this);
+    const auto target = const_cast<Section*>(section);
+
+    if (not m_locks) {
+        file->load(*target);
+        return;
+    }
+
+    const auto sections = std::shared_lock{m_locks->sections};
+
+    {
+        const auto lock = std::shared_lock{m_locks->shard(section)};
+
+        if (section->m_pending.data() == nullptr) {
+            return;
+        }
+    }
+
+    const auto lock = std::unique_lock{m_locks->shard(section)};
+    file->load(*target);
+}
+
+/// \details If a Section with the same fully qualified title already exists, the index keeps pointing to the first one.
+/// The Section objects are allocated next to each other, so iterating over them does not jump around in memory.
+/// \param title The title of the new Section.
+/// \param parent The parent of the new Section or nullptr for a top-level Section.
+/// \returns A pointer to the new Section.
+auto File::addSection(std::string_view title, Section* parent) -> Section*
+{
+    // In an arena, the Sections do not own the pool, so they do not have to be destroyed before the arena is released
+    const auto pool = m_arena ? std::shared_ptr<StringPool>{std::shared_ptr<void>{}, m_pool.get()} : m_pool;
+    const auto resource = m_arena ? m_arena.get() : std::pmr::get_default_resource();
+    const auto section = m_storage.emplace_back(std::pmr::polymorphic_allocator<>{m_sectionStorage.get()}.new_object<Section>(title, parent, pool, resource)).get();
+
+    m_index.emplace(m_sections.emplace_back(section)->fqTitle(), section);
+
+    return section;
+}
+
+/// \details Existing Sections are found with a shared lock. Only if the Section is missing, the Sections are locked
+/// exclusively and the missing part of the tree is created.
+/// \param fqTitle The fully qualified title of the Section to create.
+/// \returns A pointer to the created Section.
+auto File::makeSection(std::string_view fqTitle) -> Section*
+{
+    if (const auto section = findSection(fqTitle); section) {
+        return const_cast<Section*>(section);
+    }
+
+    const auto lock = m_locks ? std::unique_lock{m_locks->sections} : std::unique_lock<std::shared_mutex>{};
+    return insertSection(fqTitle);
+}
+
+/// \details Looks up the Section and its parents in the index and creates the missing part of the tree. Another thread
+/// may have created the Section since makeSection() looked for it, so the index is searched again.
+/// \param fqTitle The fully qualified title of the Section to create.
+/// \returns A pointer to the created Section.
+auto File::insertSection(std::string_view fqTitle) -> Section*
+{
+    if (const auto section = m_index.find(fqTitle); section != m_index.end()) {
+        return section->second;
+    }
+
+    if (fqTitle.find('.') == std::string_view::npos) {
+        return addSection(fqTitle, nullptr);
+    } else {
+        const auto parent = insertSection(fqTitle.substr(0, fqTitle.find_last_of('.')));
+        return addSection(fqTitle.substr(fqTitle.find_last_of('.') + 1), parent);
+    }
+}
+
+/// \details An existing Entry only gets the new value and keeps its position in the file, so flush() can replace the
+/// value in place. The Entry gets the Section as its parent in any case, which is where flush() finds its position.
+/// With an arena, the value is copied into it, so the Entry does not own any memory. A thread-safe File only locks the
+/// shard of the Section while the Entry is changed.
+/// \param section The fully qualified title of the Section. The Section is created if it does not exist.
+/// \param entry The Entry to set.
+auto File::apply(std::string_view section, Entry entry) -> void
+{
+    const auto target = makeSection(section);
+    const auto sections = m_locks ? std::shared_lock{m_locks->sections} : std::shared_lock<std::shared_mutex>{};
+    const auto lock = m_locks ? std::unique_lock{m_locks->shard(target)} : std::unique_lock<std::shared_mutex>{};
+    const auto [position, inserted] = target->m_entries.try_emplace(target->stableKey(entry), std::move(entry));
+    auto& stored = position->second;
 
-    for (std::string line; std::getline(content, line);) {
-        std::string_view lineView{line};
+    if (not inserted) {
+        stored.m_data = std::move(entry.m_data);
+        stored.m_cache.clear();
+    }
+
+    if (m_arena) {
+        stored.m_data = copy(stored.data());
+    }
+
+    stored.m_parent = target;
+
+    const auto changes = m_locks ? std::unique_lock{m_locks->changes} : std::unique_lock<std::mutex>{};
+    m_changed.emplace_back(target, position - target->m_entries.begin());
+}
+
+/// \note The copy is only released together with the arena.
+/// \param text The text to copy.
+/// \returns A view on the copy.
+auto File::copy(std::string_view text) -> std::string_view
+{
+    if (text.empty()) {
+        return {};
+    }
+
+    const auto data = static_cast<char*>(m_arena->allocate(text.size(), 1));
+    std::memcpy(data, text.data(), text.size());
+
+    return {data, text.size()};
+}
 
-        if (lineView.empty()) {
+/// \details The layout of the file is recorded while the content is written, so later flushes can patch it.
+/// The content is serialized into a single buffer and written at once. A mapped file must not be rewritten in place
+/// while entries still reference its pages, so it is replaced like with FlushMode::Atomic, but without waiting for
+/// the disk unless that mode is selected.
+auto File::write() -> void
+{
+    loadAll();
+
+    auto content = Patch{0, m_fileSize};
+
+    for (const auto section: m_sections) {
+        content.appendSection(*section);
+    }
+
+    if (const auto atomic = m_options.flushMode == FlushMode::Atomic; atomic or m_mapping) {
+        replaceFile(m_filename, content.text, atomic);
+    } else {
+        std::ofstream file{m_filename, std::ios::binary};
+        file.write(content.text.data(), static_cast<std::streamsize>(content.text.size()));
+    }
+
+    content.place(0);
+
+    m_fileSize = content.text.size();
+    m_endsWithNewline = true;
+    m_writtenSections = m_sections.size();
+}
+
+/// \details Changed values replace their old text and new entries are inserted after the last line of their Section.
+/// New sections are appended to the end of the file.
+///
+/// With FlushMode::InPlace and without a memory mapping the file is changed in place. Patches in front of the first one
+/// that changes the length of the file are written where they are, everything behind it is read, spliced and written
+/// again. Changing values without changing their length or appending sections therefore only writes the changed bytes.
+/// With FlushMode::Atomic or a memory mapping the whole file is spliced and replaced instead, because a partially
+/// written file must not be visible or entries still reference the pages of the mapping.
+auto File::patch() -> void
+{
+    auto replacements = std::vector<Patch>{};
+    auto insertions = std::vector<Patch>{};
+    auto seen = std::unordered_set<const Entry*>{};
+    auto missingNewline = not m_endsWithNewline;
+
+    const auto lineBreak = [&](std::size_t offset) {
+        const auto missing = missingNewline and offset == m_fileSize;
+        missingNewline = missingNewline and not missing;
+        return std::string(missing, '\n');
+    };
+
+    for (const auto& [section, index]: m_changed) {
+        const auto entry = &(section->m_entries.begin() + static_cast<std::ptrdiff_t>(index))->second;
+
+        if (not seen.insert(entry).second) {
             continue;
         }
 
-        if (lineView[0] == '[') {
-            lineView = lineView.substr(1);
+        if (entry->m_offset != std::string::npos) {
+            replacements.push_back({section->m_start + entry->m_offset, entry->m_length, std::string(entry->data()), {{entry, section, 0}}});
+        } else if (section->m_end != std::string::npos) {
+            auto insertion = Patch{section->m_end, 0, lineBreak(section->m_end)};
+            insertion.text.append(entry->key()).append("=");
+            insertion.entries.emplace_back(entry, section, insertion.text.size());
+            insertion.text.append(entry->data()).append("\n");
+            insertions.push_back(std::move(insertion));
+        }
+    }
+
+    if (m_writtenSections < m_sections.size()) {
+        // The line break ends the last line of the file, so it is a patch of its own that moves the end of the last
+        // Section instead of being part of the appended Sections
+        if (auto text = lineBreak(m_fileSize); not text.empty()) {
+            insertions.push_back({m_fileSize, 0, std::move(text)});
+        }
 
-            Section* parent = lineView.at(0) == '.' ? m_sections.back() : nullptr;
+        auto sections = Patch{m_fileSize, 0};
 
-            if (lineView[0] == '.') {
-                lineView = lineView.substr(1);
-            } else if (const auto section = std::find_if(std::begin(m_sections), std::end(m_sections), [&lineView](const auto& section) {
-                return section->fqTitle() == lineView.substr(0, lineView.find_last_of('.'));
-            }); section != std::end(m_sections)) {
-                parent = *section;
-                lineView = lineView.substr(lineView.find_last_of('.') + 1);
+        for (auto i = m_writtenSections; i < m_sections.size(); ++i) {
+            sections.appendSection(*m_sections[i]);
+        }
+
+        insertions.push_back(std::move(sections));
+    }
+
+    // Replacements go first, so a value at the end of the file is replaced before anything is appended behind it
+    auto patches = std::move(replacements);
+    std::ranges::move(insertions, std::back_inserter(patches));
+    std::ranges::stable_sort(patches, {}, &Patch::offset);
+
+    const auto atomic = m_options.flushMode == FlushMode::Atomic;
+    const auto replace = atomic or m_mapping;
+    const auto first = std::ranges::find_if(patches, [](const Patch& patch) { return patch.text.size() != patch.length; });
+    const auto spliced = replace ? patches.begin() : first;
+    const auto from = spliced == patches.end() ? m_fileSize : replace ? 0 : spliced->offset;
+    auto positions = std::vector<std::size_t>(patches.size());
+    auto size = m_fileSize;
+
+    {
+        auto file = std::fstream{m_filename, replace ? std::ios::in | std::ios::binary : std::ios::in | std::ios::out | std::ios::binary};
+
+        for (auto patch = patches.begin(); patch != spliced; ++patch) {
+            positions[patch - patches.begin()] = patch->offset;
+            file.seekp(static_cast<std::streamoff>(patch->offset));
+            file.write(patch->text.data(), static_cast<std::streamsize>(patch->text.size()));
+        }
+
+        if (spliced != patches.end()) {
+            auto old = std::string(m_fileSize - from, '\0');
+            file.seekg(static_cast<std::streamoff>(from));
+            file.read(old.data(), static_cast<std::streamsize>(old.size()));
+
+            auto content = std::string{};
+            auto position = from;
+
+            for (auto patch = spliced; patch != patches.end(); ++patch) {
+                content.append(old, position - from, patch->offset - position);
+                positions[patch - patches.begin()] = from + content.size();
+                content.append(patch->text);
+                position = patch->offset + patch->length;
             }
 
-            m_sections.emplace_back(new Section(lineView.substr(0, lineView.find(']')), parent));
-        } else {
-            m_sections.back()->createEntry(lineView.substr(0, lineView.find('=')), lineView.substr(lineView.find('=') + 1));
+            content.append(old, position - from);
+            size = from + content.size();
+
+            if (replace) {
+                file.close();
+                replaceFile(m_filename, content, atomic);
+            } else {
+                file.seekp(static_cast<std::streamoff>(from));
+                file.write(content.data(), static_cast<std::streamsize>(content.size()));
+            }
         }
     }
+
+    if (not replace and size < m_fileSize) {
+        std::filesystem::resize_file(m_filename, size);
+    }
+
+    if (first != patches.end()) {
+        // Everything behind a patch that changes the length of the file moves. Entries are positioned relative to their
+        // Section, so only the entries of Sections that contain such a patch have to be visited.
+        auto shifts = std::vector<std::ptrdiff_t>{0};
+        auto changes = std::vector<std::size_t>{0};
+
+        for (const auto& patch: patches) {
+            shifts.push_back(shifts.back() + static_cast<std::ptrdiff_t>(patch.text.size()) - static_cast<std::ptrdiff_t>(patch.length));
+            changes.push_back(changes.back() + (patch.text.size() != patch.length));
+        }
+
+        const auto before = [&](std::size_t offset) { return std::ranges::lower_bound(patches, offset, {}, &Patch::offset) - patches.begin(); };
+        const auto upTo = [&](std::size_t offset) { return std::ranges::upper_bound(patches, offset, {}, &Patch::offset) - patches.begin(); };
+        const auto shift = [&](std::size_t offset, std::ptrdiff_t patch) { return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offset) + shifts[patch]); };
+        // New Sections are appended behind the last Section, so they must not move its end
+        const auto appended = static_cast<std::ptrdiff_t>(m_writtenSections < m_sections.size());
+        const auto endOf = [&](std::size_t offset) { const auto last = upTo(offset); return last == std::ssize(patches) ? last - appended : last; };
+
+        for (auto i = std::size_t{0}; i < m_writtenSections; ++i) {
+            const auto section = m_sections[i];
+            const auto start = section->m_start;
+            const auto end = section->m_end;
+            section->m_start = shift(start, upTo(start));
+            section->m_end = shift(end, endOf(end));
+
+            if (changes[before(end)] == changes[upTo(start)]) {
+                continue;
+            }
+
+            for (auto& [_, entry]: section->m_entries) {
+                if (entry.m_offset != std::string::npos) {
+                    const auto offset = start + entry.m_offset;
+                    entry.m_offset = shift(offset, before(offset)) - section->m_start;
+                }
+            }
+        }
+    }
+
+    for (auto i = std::size_t{0}; i < patches.size(); ++i) {
+        patches[i].place(positions[i]);
+    }
+
+    m_fileSize = size;
+    m_endsWithNewline = not missingNewline;
+    m_writtenSections = m_sections.size();
+}
+
+/// \details The Section is looked up again if the File was reloaded since it was found or if it did not exist.
+/// \returns A pointer to the Section if it exists, nullptr otherwise.
+auto SectionHandle::get() const -> const Section*
+{
+    if (not m_file) {
+        return nullptr;
+    }
+
+    if (not current() or not m_section) {
+        m_generation = m_file->m_generation.load(std::memory_order_acquire);
+        m_section = m_file->findSection(m_title);
+    }
+
+    return m_section;
+}
+
+/// \param key The key of the Entry.
+/// \returns A handle that reads the Entry without looking it up again.
+auto SectionHandle::key(std::string_view key) const -> KeyHandle
+{
+    if (not m_file) {
+        return {};
+    }
+
+    auto handle = KeyHandle{*this, m_file->m_pool->intern(key)};
+    handle.entry();
+    return handle;
+}
+
+auto SectionHandle::current() const -> bool
+{
+    return m_file->m_generation.load(std::memory_order_acquire) == m_generation;
+}
+
+/// \details The pointer is valid until the Section of the Entry changes, like the one returned by File::findEntry().
+/// \returns A pointer to the Entry if its key exists, nullptr otherwise.
+auto KeyHandle::entry() const -> const Entry*
+{
+    return visit([](const Entry* entry) { return entry; });
+}
+
+/// \details Entries are only appended between reloads, so a position found in the same generation still holds the
+/// Entry. Otherwise the key is looked up and its position remembered.
+/// \param section The Section of the Entry.
+/// \returns A pointer to the Entry if its key exists, nullptr otherwise.
+auto KeyHandle::locate(const Section& section) const -> const Entry*
+{
+    if (m_generation != m_section.m_generation) {
+        m_generation = m_section.m_generation;
+        m_index = std::string_view::npos;
+    }
+
+    const auto& entries = section.entries();
+
+    if (m_index < entries.size()) {
+        return &(entries.begin() + static_cast<std::ptrdiff_t>(m_index))->second;
+    }
+
+    const auto position = entries.find(m_key);
+
+    if (position == entries.end()) {
+        return nullptr;
+    }
+
+    m_index = static_cast<std::size_t>(position - entries.begin());
+    return &position->second;
 }
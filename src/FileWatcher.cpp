@@ -0,0 +1,103 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "FileWatcher.h"
+
+#include <filesystem>
+#include <system_error>
+
+#ifdef __linux__
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+/// \details Writing, creating, moving and deleting files in the directory are reported. The descriptor does not block,
+/// so changed() returns immediately if nothing happened.
+/// \param filename The name of the file to watch.
+/// \throws std::system_error if the directory of the file cannot be watched.
+FileWatcher::FileWatcher(const std::string& filename)
+    : m_descriptor{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+    , m_name{std::filesystem::path{filename}.filename().string()}
+{
+    if (m_descriptor < 0) {
+        throw std::system_error{errno, std::system_category(), "Could not watch " + filename};
+    }
+
+    const auto directory = std::filesystem::path{filename}.parent_path();
+    const auto events = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_DELETE;
+
+    if (::inotify_add_watch(m_descriptor, directory.empty() ? "." : directory.c_str(), events) < 0) {
+        const auto error = errno;
+        ::close(m_descriptor);
+        throw std::system_error{error, std::system_category(), "Could not watch " + filename};
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+    ::close(m_descriptor);
+}
+
+/// \details All pending events are read, so a burst of writes is reported only once. Events for other files in the
+/// same directory are skipped. If events were lost, a change is reported.
+/// \returns true if the file was written, created, replaced or deleted since the last call.
+auto FileWatcher::changed() -> bool
+{
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    auto changed = false;
+
+    for (;;) {
+        const auto size = ::read(m_descriptor, buffer.data(), buffer.size());
+
+        if (size <= 0) {
+            return changed;
+        }
+
+        for (auto position = buffer.data(); position < buffer.data() + size;) {
+            inotify_event event;
+            std::memcpy(&event, position, sizeof event);
+
+            changed = changed or (event.mask & IN_Q_OVERFLOW) or (event.len != 0 and m_name == position + sizeof event);
+            position += sizeof event + event.len;
+        }
+    }
+}
+
+#else
+
+/// \param filename The name of the file to watch.
+FileWatcher::FileWatcher(const std::string& filename)
+    : m_name{std::filesystem::path{filename}.filename().string()}
+{
+}
+
+FileWatcher::~FileWatcher() = default;
+
+/// \returns Always true, because changes cannot be noticed without looking at the file.
+auto FileWatcher::changed() -> bool
+{
+    return true;
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+
+/// \brief Notices changes to a file on disk without reading it
+/// \details On Linux, the directory of the file is watched with inotify, so the file is still watched after an editor
+/// replaced it by renaming another file over it. On other platforms no notifications are available and every call to
+/// changed() reports a possible change, so the caller has to compare the size and the write time of the file itself.
+class FileWatcher {
+public:
+    explicit FileWatcher(const std::string& filename); ///< Start watching the file. Throws if it cannot be watched.
+    ~FileWatcher(); ///< Stop watching the file
+
+    FileWatcher(const FileWatcher&) = delete;
+    auto operator=(const FileWatcher&) -> FileWatcher& = delete;
+
+    auto changed() -> bool; ///< Whether the file may have changed since the last call. Does not block.
+    auto handle() const -> int { return m_descriptor; } ///< Descriptor that becomes readable when the file changes, -1 if there is none
+
+private:
+    int m_descriptor {-1};
+    std::string m_name {}; ///< Name of the file in its directory
+};
@@ -0,0 +1,230 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/FrozenFile.h>
+#include <cppIni/File.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+/// \details All titles, keys and values are copied, so the FrozenFile stays valid after the File was changed or
+/// destroyed. The Sections keep the order of the File and the entries of every Section are stored next to each other.
+/// \param file The File to copy.
+FrozenFile::FrozenFile(const File& file)
+    : m_arena{std::make_unique<std::pmr::monotonic_buffer_resource>()}
+    , m_pool{std::make_shared<StringPool>(0, m_arena.get())}
+{
+    std::unordered_map<const Section*, Section*> copies;
+    m_sections.reserve(file.sections().size());
+
+    for (const auto section : file.sections()) {
+        // Parents always precede their subsections
+        const auto parent = section->parent() ? copies.at(section->parent()) : nullptr;
+        auto& copy = m_sections.emplace_back(section->title(), parent, m_pool, m_arena.get());
+        copies.emplace(section, &copy);
+
+        copy.m_entries.reserve(section->entries().size());
+        for (const auto& [key, entry] : section->entries()) {
+            copy.addEntry(Entry::borrow(m_pool->intern(key), this->copy(entry.data()), &copy));
+        }
+    }
+
+    std::unordered_set<std::string_view> titles;
+    std::vector<const Section*> sections;
+    std::vector<EntrySlot> entries;
+
+    for (const auto& section : m_sections) {
+        if (titles.insert(section.fqTitle()).second) {
+            sections.push_back(&section);
+
+            for (const auto& [key, entry] : section.entries()) {
+                entries.push_back({section.fqTitle(), key, &entry});
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> sectionHashes(sections.size());
+    std::vector<std::uint64_t> entryHashes(entries.size());
+
+    // Distinct names may have the same hash for one seed, so the seed is changed until both functions can be built
+    for (;; ++m_seed) {
+        std::ranges::transform(sections, sectionHashes.begin(), [this](const Section* section) {
+            return sectionHash(section->fqTitle());
+        });
+        std::ranges::transform(entries, entryHashes.begin(), [this](const EntrySlot& slot) {
+            return entryHash(slot.section, slot.key);
+        });
+
+        if (m_sectionIndex.build(sectionHashes) and m_entryIndex.build(entryHashes)) {
+            break;
+        }
+    }
+
+    m_sectionSlots.resize(sections.size());
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        m_sectionSlots[m_sectionIndex(sectionHashes[i])] = sections[i];
+    }
+
+    m_entrySlots.resize(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        m_entrySlots[m_entryIndex(entryHashes[i])] = entries[i];
+    }
+}
+
+/// \details The previous contents of this FrozenFile are moved into a temporary FrozenFile, whose destructor destroys
+/// the Sections before the arena they were allocated from. The members are then moved one by one.
+auto FrozenFile::operator=(FrozenFile&& other) noexcept -> FrozenFile&
+{
+    if (this != &other) {
+        auto previous = FrozenFile{std::move(*this)};
+
+        m_arena = std::move(other.m_arena);
+        m_pool = std::move(other.m_pool);
+        m_sections = std::move(other.m_sections);
+        m_seed = other.m_seed;
+        m_sectionIndex = std::move(other.m_sectionIndex);
+        m_sectionSlots = std::move(other.m_sectionSlots);
+        m_entryIndex = std::move(other.m_entryIndex);
+        m_entrySlots = std::move(other.m_entrySlots);
+    }
+
+    return *this;
+}
+
+/// \details The copy is null terminated, so Entry::value<const char*>() can be used on every Entry.
+/// \arg text The text to copy
+/// \returns A view on the copy, valid as long as the FrozenFile exists
+auto FrozenFile::copy(std::string_view text) -> std::string_view
+{
+    const auto data = static_cast<char*>(m_arena->allocate(text.size() + 1, alignof(char)));
+    std::memcpy(data, text.data(), text.size());
+    data[text.size()] = '\0';
+    return {data, text.size()};
+}
+
+/// \details Buckets are placed from the largest to the smallest. For a bucket with several hashes the displacements
+/// 1, 2, ... are tried until all its hashes land in distinct free slots. A bucket with a single hash takes the next
+/// free slot directly, which is stored as a negative displacement. About two hashes share a bucket, which keeps the
+/// search short and the table small.
+/// \arg hashes The distinct hashes to map
+/// \returns false if two hashes are equal or no displacement was found for a bucket
+auto FrozenFile::PerfectHash::build(std::span<const std::uint64_t> hashes) -> bool
+{
+    constexpr std::uint32_t maxDisplacement = 1u << 20;
+
+    m_size = hashes.size();
+    m_displacements.assign(std::max<std::size_t>(1, hashes.size() / 2), 0);
+
+    if (hashes.empty()) {
+        return true;
+    }
+
+    // Counting sort of the hashes by bucket, so the members of bucket b are members[offsets[b], offsets[b + 1])
+    std::vector<std::uint32_t> offsets(m_displacements.size() + 1, 0);
+    for (const auto hash : hashes) {
+        ++offsets[reduce(hash, m_displacements.size()) + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<std::uint64_t> members(hashes.size());
+    auto cursor = offsets;
+    for (const auto hash : hashes) {
+        members[cursor[reduce(hash, m_displacements.size())]++] = hash;
+    }
+
+    // Counting sort of the buckets by size, largest first
+    std::size_t maxSize = 0;
+    for (std::size_t bucket = 0; bucket < m_displacements.size(); ++bucket) {
+        maxSize = std::max<std::size_t>(maxSize, offsets[bucket + 1] - offsets[bucket]);
+    }
+
+    std::vector<std::uint32_t> bySize(maxSize + 2, 0);
+    for (std::size_t bucket = 0; bucket < m_displacements.size(); ++bucket) {
+        ++bySize[maxSize - (offsets[bucket + 1] - offsets[bucket]) + 1];
+    }
+    std::partial_sum(bySize.begin(), bySize.end(), bySize.begin());
+
+    std::vector<std::uint32_t> order(m_displacements.size());
+    for (std::size_t bucket = 0; bucket < m_displacements.size(); ++bucket) {
+        order[bySize[maxSize - (offsets[bucket + 1] - offsets[bucket])]++] = static_cast<std::uint32_t>(bucket);
+    }
+
+    std::vector<bool> taken(m_size, false);
+    std::vector<std::size_t> slots;
+    std::size_t freeSlot = 0;
+
+    for (const auto bucket : order) {
+        const auto first = members.begin() + offsets[bucket];
+        const auto last = members.begin() + offsets[bucket + 1];
+        const auto size = static_cast<std::size_t>(last - first);
+
+        if (size == 0) {
+            break;
+        }
+
+        if (size == 1) {
+            while (taken[freeSlot]) {
+                ++freeSlot;
+            }
+
+            taken[freeSlot] = true;
+            m_displacements[bucket] = -static_cast<std::int32_t>(freeSlot) - 1;
+            continue;
+        }
+
+        // Equal hashes always share a bucket and can never be separated
+        std::sort(first, last);
+        if (std::adjacent_find(first, last) != last) {
+            return false;
+        }
+
+        auto displacement = 1u;
+        for (; displacement < maxDisplacement; ++displacement) {
+            slots.clear();
+
+            for (auto hash = first; hash != last; ++hash) {
+                const auto slot = reduce(mix(*hash + displacement), m_size);
+
+                if (taken[slot] or std::ranges::find(slots, slot) != slots.end()) {
+                    break;
+                }
+
+                slots.push_back(slot);
+            }
+
+            if (slots.size() == size) {
+                break;
+            }
+        }
+
+        if (displacement == maxDisplacement) {
+            return false;
+        }
+
+        for (const auto slot : slots) {
+            taken[slot] = true;
+        }
+
+        m_displacements[bucket] = static_cast<std::int32_t>(displacement);
+    }
+
+    return true;
+}
@@ -0,0 +1,135 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LineScanner.h"
+
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPPINI_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CPPINI_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CPPINI_SSE2
+#endif
+
+#if defined(CPPINI_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CPPINI_AVX2 __attribute__((target("avx2")))
+#elif defined(CPPINI_X86) && defined(_MSC_VER)
+#define CPPINI_AVX2
+#endif
+
+/// \details Written without branches, so the compiler can vectorize it for the target.
+static auto scalarScan(const char* block) -> BlockMasks
+{
+    auto masks = BlockMasks{0, 0};
+
+    for (std::size_t i = 0; i < scanBlockSize; ++i) {
+        masks.newlines |= std::uint64_t{block[i] == '\n'} << i;
+        masks.separators |= std::uint64_t{block[i] == '='} << i;
+    }
+
+    return masks;
+}
+
+#ifdef CPPINI_SSE2
+static auto sse2Scan(const char* block) -> BlockMasks
+{
+    const auto newline = _mm_set1_epi8('\n');
+    const auto separator = _mm_set1_epi8('=');
+    auto masks = BlockMasks{0, 0};
+
+    for (std::size_t i = 0; i < scanBlockSize / 16; ++i) {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+        masks.newlines |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)))} << (i * 16);
+        masks.separators |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, separator)))} << (i * 16);
+    }
+
+    return masks;
+}
+#endif
+
+#ifdef CPPINI_AVX2
+CPPINI_AVX2 static auto avx2Scan(const char* block) -> BlockMasks
+{
+    const auto newline = _mm256_set1_epi8('\n');
+    const auto separator = _mm256_set1_epi8('=');
+    auto masks = BlockMasks{0, 0};
+
+    for (std::size_t i = 0; i < scanBlockSize / 32; ++i) {
+        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * 32));
+        masks.newlines |= std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, newline)))} << (i * 32);
+        masks.separators |= std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, separator)))} << (i * 32);
+    }
+
+    return masks;
+}
+
+/// \returns Whether the processor and the operating system support AVX2.
+static auto hasAvx2() -> bool
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // The operating system has to save the AVX registers as well
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 or (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+auto blockScanners() -> std::span<const BlockScanner>
+{
+    static const auto scanners = [] {
+        auto available = std::vector<BlockScanner>{};
+#ifdef CPPINI_AVX2
+        if (hasAvx2()) {
+            available.push_back(&avx2Scan);
+        }
+#endif
+#ifdef CPPINI_SSE2
+        available.push_back(&sse2Scan);
+#endif
+        available.push_back(&scalarScan);
+        return available;
+    }();
+
+    return scanners;
+}
+
+auto blockScanner() -> BlockScanner
+{
+    static const auto scanner = blockScanners().front();
+
+    return scanner;
+}
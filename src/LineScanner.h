@@ -0,0 +1,133 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cppIni/cppini_export.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+/// \brief Positions of the characters the parser looks for in a block of scanBlockSize bytes
+struct BlockMasks {
+    std::uint64_t newlines; ///< Bit i is set if byte i is a line break
+    std::uint64_t separators; ///< Bit i is set if byte i is a '='
+};
+
+constexpr std::size_t scanBlockSize = 64;
+
+/// \brief Classifies the bytes of one block
+using BlockScanner = auto (*)(const char* block) -> BlockMasks;
+
+/// \brief Every BlockScanner this processor supports
+/// \details AVX2 and SSE2 kernels are available on x86 if the processor supports them. The portable kernel is always
+/// available and comes last. The kernels are detected on the first call. Exported, so the tests can compare all of them.
+/// \returns The kernels, the fastest first.
+CPPINI_EXPORT auto blockScanners() -> std::span<const BlockScanner>;
+
+/// \brief The fastest BlockScanner this processor supports
+CPPINI_EXPORT auto blockScanner() -> BlockScanner;
+
+/// \brief Calls a function for every line of a text
+/// \details The text is classified a block at a time, so a line break and the first '=' of a line are found without
+/// looking at every byte again. The last line is reported even without a line break.
+/// \param content The text to scan.
+/// \param function Called with the line without its line break, the position of the line in content and the position of
+/// the first '=' in the line or std::string_view::npos if there is none.
+template<class F>
+auto scanLines(std::string_view content, F&& function) -> void
+{
+    const auto scan = blockScanner();
+    auto start = std::size_t{0};
+    auto separator = std::string_view::npos;
+
+    for (std::size_t block = 0; block < content.size(); block += scanBlockSize) {
+        auto masks = BlockMasks{};
+
+        if (content.size() - block >= scanBlockSize) {
+            masks = scan(content.data() + block);
+        } else {
+            std::array<char, scanBlockSize> tail {};
+            std::memcpy(tail.data(), content.data() + block, content.size() - block);
+            masks = scan(tail.data());
+        }
+
+        for (auto newlines = masks.newlines; newlines != 0; newlines &= newlines - 1) {
+            const auto bit = std::countr_zero(newlines);
+            const auto before = masks.separators & ((std::uint64_t{1} << bit) - 1);
+
+            if (separator == std::string_view::npos and before != 0) {
+                separator = block + std::countr_zero(before);
+            }
+
+            const auto end = block + bit;
+            function(content.substr(start, end - start), start, separator == std::string_view::npos ? separator : separator - start);
+
+            start = end + 1;
+            separator = std::string_view::npos;
+            masks.separators &= ~((std::uint64_t{2} << bit) - 1);
+        }
+
+        if (separator == std::string_view::npos and masks.separators != 0) {
+            separator = block + std::countr_zero(masks.separators);
+        }
+    }
+
+    if (start < content.size()) {
+        function(content.substr(start), start, separator == std::string_view::npos ? separator : separator - start);
+    }
+}
+
+/// \brief Calls a function for every line of a range that starts with '['
+/// \details Only the rare '[' is searched for, so the lines in between are skipped at the speed of memchr. Empty lines
+/// in front of the next title do not belong to the title.
+/// \param content The text to search.
+/// \param begin The start of a line in content where the search starts.
+/// \param end The start of a line in content where the search stops.
+/// \param function Called with the position of the title line and the position after the last non-empty line up to the
+/// next title.
+template<class F>
+auto findTitles(std::string_view content, std::size_t begin, std::size_t end, F&& function) -> void
+{
+    const auto next = [content, end](std::size_t from) {
+        for (auto bracket = content.find('[', from); bracket < end; bracket = content.find('[', bracket + 1)) {
+            if (bracket == 0 or content[bracket - 1] == '\n') {
+                return bracket;
+            }
+        }
+
+        return end;
+    };
+
+    for (auto title = next(begin); title < end;) {
+        const auto following = next(title + 1);
+        auto last = following;
+
+        while (last - title >= 2 and content[last - 1] == '\n' and content[last - 2] == '\n') {
+            --last;
+        }
+
+        function(title, last);
+        title = following;
+    }
+}
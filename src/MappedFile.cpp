@@ -0,0 +1,107 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+/// \details Windows does not allow replacing a file while a view of it is mapped, which File::flush() relies on. The
+/// file is therefore read into a private buffer with a single call instead of being mapped.
+/// \param filename The name of the file to map.
+/// \throws std::runtime_error if the file exists but cannot be read.
+MappedFile::MappedFile(const std::string& filename)
+{
+    const auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) or size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    m_buffer = std::make_unique_for_overwrite<char[]>(m_size);
+
+    DWORD read = 0;
+    const auto success = ReadFile(file, m_buffer.get(), static_cast<DWORD>(m_size), &read, nullptr);
+    CloseHandle(file);
+
+    if (!success or read != m_size) {
+        throw std::runtime_error{"Could not read " + filename};
+    }
+
+    m_data = m_buffer.get();
+}
+
+MappedFile::~MappedFile() = default;
+
+#else
+
+/// \param filename The name of the file to map.
+/// \throws std::runtime_error if the file exists but cannot be mapped.
+MappedFile::MappedFile(const std::string& filename)
+{
+    const auto fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 or status.st_size == 0) {
+        ::close(fd);
+        return;
+    }
+
+    const auto size = static_cast<std::size_t>(status.st_size);
+    const auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED) {
+        throw std::runtime_error{"Could not map " + filename};
+    }
+
+    ::madvise(data, size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char*>(data);
+    m_size = size;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#endif
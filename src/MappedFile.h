@@ -0,0 +1,45 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+/// \brief Read-only memory mapping of a whole file
+/// \details The file is mapped once on construction and unmapped on destruction. A file that does not exist or is
+/// empty results in an empty mapping. The mapping stays valid if the file is replaced on disk, but not if it is
+/// truncated or rewritten in place.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename); ///< Map the file. Throws if an existing file cannot be mapped.
+    ~MappedFile(); ///< Unmap the file
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    auto content() const -> std::string_view { return {m_data, m_size}; } ///< Mapped bytes as std::string_view
+
+private:
+    const char* m_data {nullptr};
+    std::size_t m_size {0};
+#ifdef _WIN32
+    std::unique_ptr<char[]> m_buffer {};
+#endif
+};
@@ -0,0 +1,47 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/Parser.h>
+
+/// \details A title starting with '.' is appended to the title of the current Section. Any other title is fully
+/// qualified already, e.g. [A.B] names the Section B inside A. Text behind the closing bracket is ignored.
+/// \param line The title line without its line break.
+/// \param offset The position of the line in the input.
+/// \returns The parsed title, valid until the next title is parsed.
+auto Parser::title(std::string_view line, std::size_t offset) -> ParsedSection
+{
+    auto title = line.substr(1);
+    const auto relative = not title.empty() and title[0] == '.';
+
+    if (relative) {
+        title = title.substr(1);
+    }
+
+    title = title.substr(0, title.find(']'));
+
+    if (relative and m_inSection) {
+        m_fqTitle += '.';
+        m_fqTitle += title;
+    } else {
+        m_fqTitle = title;
+    }
+
+    m_inSection = true;
+
+    return {m_fqTitle, title, relative, line, offset};
+}
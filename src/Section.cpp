@@ -19,51 +19,130 @@
 #include <cppIni/Section.h>
 
 #include <algorithm>
+#include <memory>
 
-Section::Section(std::string_view title, const Section* parent)
-    : m_title(title)
+/// If the Section is a top-level Section, the fully qualified title is the title.
+/// Otherwise, the title is prefixed with the parent's fully qualified title and a dot.
+/// \param title The title of the Section.
+/// \param parent The parent Section or nullptr for a top-level Section.
+/// \param pool The pool storing the title and keys. A new pool is created if none is given.
+/// \param resource The memory resource the entries are allocated from.
+Section::Section(std::string_view title, const Section* parent, std::shared_ptr<StringPool> pool, std::pmr::memory_resource* resource)
+    : m_pool(pool ? std::move(pool) : std::make_shared<StringPool>())
+    , m_fqTitle(parent ? m_pool->intern(std::string(parent->fqTitle()) + "." + std::string(title)) : m_pool->intern(title))
+    , m_title(m_fqTitle.substr(m_fqTitle.size() - title.size()))
+    , m_entries(resource)
     , m_parent(parent)
 {
 
 }
 
+/// \details The entries are copied into storage of the default memory resource. Borrowed keys and values and the pool
+/// are shared with the other Section, so a copy of a Section of a File must not outlive that File.
+/// \param other The Section to copy.
+Section::Section(const Section& other)
+    : m_pool(other.m_pool)
+    , m_fqTitle(other.m_fqTitle)
+    , m_title(other.m_title)
+    , m_entries(other.m_entries)
+    , m_parent(other.m_parent)
+    , m_start(other.m_start)
+    , m_end(other.m_end)
+    , m_pending(other.m_pending)
+{
+    adopt(other);
+}
+
+/// \details The entries keep their storage and the memory resource it was allocated from, so none of them is copied.
+/// The other Section keeps its title and pool and has no entries, so it can still be used.
+/// \param other The Section to move.
+Section::Section(Section&& other) noexcept
+    : m_pool(other.m_pool)
+    , m_fqTitle(other.m_fqTitle)
+    , m_title(other.m_title)
+    , m_entries(std::move(other.m_entries))
+    , m_parent(other.m_parent)
+    , m_start(other.m_start)
+    , m_end(other.m_end)
+    , m_pending(other.m_pending)
+{
+    adopt(other);
+}
+
+/// \param other The Section to copy.
+/// \returns This Section.
+auto Section::operator=(const Section& other) -> Section&
+{
+    return *this = Section{other};
+}
+
+/// \details The Section takes over the memory resource of the other Section, so the entries are not moved one by one.
+/// The entries of this Section are destroyed before the pool their keys may refer to is released. The other Section is
+/// left in the same state as by the move constructor.
+/// \param other The Section to move.
+/// \returns This Section.
+auto Section::operator=(Section&& other) noexcept -> Section&
+{
+    if (this != &other) {
+        m_entries = std::move(other.m_entries);
+        m_pool = other.m_pool;
+        m_fqTitle = other.m_fqTitle;
+        m_title = other.m_title;
+        m_parent = other.m_parent;
+        m_start = other.m_start;
+        m_end = other.m_end;
+        m_pending = other.m_pending;
+        adopt(other);
+    }
+
+    return *this;
+}
+
 /// \note The entry is moved into the vector
 /// \arg entry The Entry to add
 auto Section::addEntry(Entry entry) -> void
 {
-    m_entries.insert(std::make_pair(entry.key(), std::move(entry)));
+    const auto key = stableKey(entry);
+    m_entries.try_emplace(key, std::move(entry));
 }
 
 /// \note The entry is moved into the vector
 /// \arg entry The Entry to add
 auto Section::setEntry(Entry entry) -> void
 {
-    m_entries.insert_or_assign(std::string(entry.key()), entry);
+    const auto key = stableKey(entry);
+    m_entries.insert_or_assign(key, std::move(entry));
 }
 
-/// If the Section is a top-level Section, the title is returned.
-/// Otherwise, the title is prefixed with the parent's fully qualified title and a dot.
-/// \returns The fully qualified title of the Section.
-auto Section::fqTitle() const -> std::string
+/// \details Keys that are borrowed already reference storage that outlives the Section. Owned keys are interned, so the
+/// map and the Entry can share a single copy.
+/// \arg entry The Entry that is about to be stored
+/// \returns The key of the Entry
+auto Section::stableKey(Entry& entry) -> std::string_view
 {
-    if (m_parent == nullptr) {
-        return m_title;
+    if (std::holds_alternative<std::string>(entry.m_key)) {
+        entry.m_key = m_pool->intern(entry.key());
     }
 
-    return m_parent->fqTitle() + "." + m_title;
+    return entry.key();
+}
+
+/// \details Entries without a parent or with another parent are left alone.
+/// \arg previous The Section the entries were copied or moved from
+auto Section::adopt(const Section& previous) -> void
+{
+    for (auto& [_, entry] : m_entries) {
+        if (entry.m_parent == &previous) {
+            entry.m_parent = this;
+        }
+    }
 }
 
 /// \param name The name of the Entry to find.
 /// \returns A pointer to the Entry if found, nullptr otherwise.
 auto Section::findEntry(std::string_view name) const -> const Entry*
 {
-    const auto entry = m_entries.find(std::string(name));
-
-    if (entry != m_entries.cend()) {
-        return &entry->second;
-    }
-
-    return nullptr;
+    return m_entries.get(name);
 }
 
 /// \details Two Sections are equal if they have the same title and the same entries. Their parents are not compared.
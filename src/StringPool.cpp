@@ -0,0 +1,95 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cppIni/StringPool.h>
+
+#include <cstring>
+
+/// \param maxValueLength Values read by a File that are not longer than this are interned, longer ones are not.
+/// \param resource The memory resource the strings and the lookup table are allocated from. It has to outlive the pool.
+StringPool::StringPool(std::size_t maxValueLength, std::pmr::memory_resource* resource)
+    : m_resource(resource)
+    , m_strings(resource)
+    , m_blocks(resource)
+    , m_maxValueLength(maxValueLength)
+{
+}
+
+StringPool::~StringPool()
+{
+    for (const auto block: m_blocks) {
+        m_resource->deallocate(block.data(), block.size(), 1);
+    }
+}
+
+/// \details If an equal string has been interned before, a view on the stored copy is returned. Otherwise the text is
+/// copied into the pool.
+/// \param text The text to intern.
+/// \returns A view on the stored copy that is valid as long as the pool exists.
+auto StringPool::intern(std::string_view text) -> std::string_view
+{
+    if (text.empty()) {
+        return "";
+    }
+
+    std::lock_guard lock{m_mutex};
+
+    if (const auto stored = m_strings.find(text); stored != m_strings.cend()) {
+        return *stored;
+    }
+
+    return *m_strings.insert(store(text)).first;
+}
+
+auto StringPool::size() const -> std::size_t
+{
+    std::lock_guard lock{m_mutex};
+    return m_strings.size();
+}
+
+auto StringPool::capacity() const -> std::size_t
+{
+    std::lock_guard lock{m_mutex};
+    return m_capacity;
+}
+
+/// \details Texts larger than a quarter of a block get a block of their own, so the current block is not wasted.
+/// \param text The text to copy.
+/// \returns A view on the copy.
+auto StringPool::store(std::string_view text) -> std::string_view
+{
+    if (text.size() > blockSize / 4) {
+        const auto block = m_blocks.emplace_back(static_cast<char*>(m_resource->allocate(text.size(), 1)), text.size());
+        m_capacity += text.size();
+        std::memcpy(block.data(), text.data(), text.size());
+        return {block.data(), text.size()};
+    }
+
+    if (text.size() > m_remaining) {
+        m_cursor = m_blocks.emplace_back(static_cast<char*>(m_resource->allocate(blockSize, 1)), blockSize).data();
+        m_remaining = blockSize;
+        m_capacity += blockSize;
+    }
+
+    const auto copy = m_cursor;
+    std::memcpy(copy, text.data(), text.size());
+    m_cursor += text.size();
+    m_remaining -= text.size();
+
+    return {copy, text.size()};
+}
@@ -68,6 +68,24 @@ TEST_CASE("Change a value")
     CHECK_EQ(cppIni_geti(*file, "Section1", "IntEntry"), newValue);
 }
 
+TEST_CASE("Change several values at once")
+{
+    utils::TempFile tmpFile(fileName);
+    auto file = utils::ScopeGuard<void*, cppIni_close>(cppIni_open(tmpFile.filename().data()));
+
+    const std::array<cppIni_entry, 2> entries {{
+        {"Section1", "IntEntry", "1337"},
+        {"Section2", "NewEntry", "3.5"},
+    }};
+    cppIni_set_many(*file, entries.data(), entries.size());
+
+    CHECK_EQ(cppIni_geti(*file, "Section1", "IntEntry"), 1337);
+    CHECK_EQ(cppIni_getf(*file, "Section2", "NewEntry"), 3.5f);
+
+    auto reopened = utils::ScopeGuard<void*, cppIni_close>(cppIni_open(tmpFile.filename().data()));
+    CHECK_EQ(cppIni_geti(*reopened, "Section1", "IntEntry"), 1337);
+}
+
 TEST_CASE("Read an integer entry")
 {
     auto file = utils::ScopeGuard<void*, cppIni_close>(cppIni_open(fileName.c_str()));
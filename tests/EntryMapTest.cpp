@@ -0,0 +1,233 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <doctest/doctest.h>
+
+#include <cppIni/EntryMap.h>
+
+#include <format>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+TEST_SUITE_BEGIN("EntryMap");
+
+TEST_CASE("Construction of an empty EntryMap")
+{
+    const EntryMap map;
+    CHECK(map.empty());
+    CHECK_EQ(map.size(), 0);
+    CHECK_EQ(map.find("Key"), map.cend());
+    CHECK_FALSE(map.contains("Key"));
+    CHECK_THROWS_AS(map.at("Key"), std::out_of_range);
+}
+
+TEST_CASE("Insert and find entries")
+{
+    EntryMap map;
+
+    const auto [first, inserted] = map.try_emplace("Key1", "Key1", 1);
+    CHECK(inserted);
+    CHECK_EQ(first->first, "Key1"sv);
+    CHECK_EQ(first->second.value<int>(), 1);
+
+    map.try_emplace("Key2", Entry{"Key2", 2});
+
+    CHECK_EQ(map.size(), 2);
+    CHECK(map.contains("Key1"));
+    CHECK_EQ(map.at("Key2").value<int>(), 2);
+    CHECK_EQ(map.find("Key3"), map.end());
+}
+
+TEST_CASE("Existing entries are not replaced by try_emplace")
+{
+    EntryMap map;
+    map.try_emplace("Key", Entry{"Key", 1});
+
+    auto entry = Entry{"Key", 2};
+    const auto [position, inserted] = map.try_emplace("Key", std::move(entry));
+
+    CHECK_FALSE(inserted);
+    CHECK_EQ(position->second.value<int>(), 1);
+    CHECK_EQ(entry.value<int>(), 2);
+}
+
+TEST_CASE("Replace an entry with insert_or_assign")
+{
+    EntryMap map;
+    map.insert_or_assign("Key", Entry{"Key", 1});
+
+    const auto [position, inserted] = map.insert_or_assign("Key", Entry{"Key", 2});
+
+    CHECK_FALSE(inserted);
+    CHECK_EQ(map.size(), 1);
+    CHECK_EQ(position->second.value<int>(), 2);
+}
+
+TEST_CASE("Entries are kept in insertion order")
+{
+    EntryMap map;
+    std::vector<std::string> keys;
+
+    for (auto i = 0; i < 1000; ++i) {
+        keys.push_back(std::format("Key{}", (i * 7919) % 1000));
+    }
+
+    for (const auto& key : keys) {
+        map.try_emplace(key, key, key.size());
+    }
+
+    REQUIRE_EQ(map.size(), keys.size());
+
+    auto key = keys.cbegin();
+    for (const auto& [name, entry] : map) {
+        CHECK_EQ(name, *key);
+        CHECK_EQ(entry.key(), *key++);
+    }
+
+    for (const auto& name : keys) {
+        CHECK_EQ(map.at(name).key(), name);
+    }
+}
+
+TEST_CASE("Reserve room for entries")
+{
+    EntryMap map;
+    map.reserve(100);
+    map.try_emplace("Key", Entry{"Key", 1});
+
+    const auto entry = &map.at("Key");
+    for (auto i = 0; i < 99; ++i) {
+        map.try_emplace(i % 2 ? "Odd"sv : "Even"sv, Entry{"Key", i});
+    }
+
+    CHECK_EQ(&map.at("Key"), entry);
+    CHECK_EQ(map.size(), 3);
+}
+
+TEST_CASE("Remove entries")
+{
+    EntryMap map;
+    for (const auto key : {"A"sv, "B"sv, "C"sv, "D"sv}) {
+        map.try_emplace(key, Entry{key, 1});
+    }
+
+    CHECK_EQ(map.erase("B"), 1);
+    CHECK_EQ(map.erase("B"), 0);
+    CHECK_EQ(map.erase("E"), 0);
+    CHECK_EQ(map.size(), 3);
+    CHECK_FALSE(map.contains("B"));
+    CHECK_EQ(map.at("D").key(), "D");
+    CHECK_EQ(map.begin()[1].first, "C");
+
+    map.try_emplace("B", Entry{"B", 2});
+    CHECK_EQ(map.at("B").value<int>(), 2);
+    CHECK_EQ((map.end() - 1)->first, "B");
+}
+
+TEST_CASE("Remove several entries at once")
+{
+    std::vector<std::string> keys;
+    for (auto i = 0; i < 100; ++i) {
+        keys.push_back(std::format("Key{}", i));
+    }
+
+    EntryMap map;
+    std::vector<const Entry*> addresses;
+    for (auto i = 0; i < 100; ++i) {
+        addresses.push_back(&map.try_emplace(keys[i], Entry{keys[i], i}).first->second);
+    }
+
+    CHECK_EQ(map.erase_if([](const EntryMap::value_type& entry) { return entry.second.value<int>() % 3 == 0; }), 34);
+    CHECK_EQ(map.erase_if([](const EntryMap::value_type&) { return false; }), 0);
+    CHECK_EQ(map.size(), 66);
+    CHECK_FALSE(map.contains("Key0"));
+    CHECK_FALSE(map.contains("Key99"));
+    CHECK_EQ(map.get("Key98"), addresses[98]);
+    CHECK_EQ(map.begin()->first, "Key1");
+    CHECK_EQ(map.begin()[2].first, "Key4");
+    CHECK_EQ((map.end() - 1)->first, "Key98");
+
+    // A removed key can be added again
+    map.try_emplace(keys[0], Entry{keys[0], 0});
+    CHECK_EQ(map.at("Key0").value<int>(), 0);
+    CHECK_EQ((map.end() - 1)->first, "Key0");
+}
+
+TEST_CASE("Entries keep their address when other entries are added or removed")
+{
+    std::vector<std::string> keys;
+    for (auto i = 0; i < 200; ++i) {
+        keys.push_back(std::format("Key{}", i));
+    }
+
+    EntryMap map;
+    std::vector<const Entry*> addresses;
+    for (auto i = 0; i < 100; ++i) {
+        addresses.push_back(&map.try_emplace(keys[i], Entry{keys[i], i}).first->second);
+    }
+
+    for (auto i = 0; i < 100; i += 2) {
+        CHECK_EQ(map.erase(keys[i]), 1);
+    }
+
+    for (auto i = 100; i < 200; ++i) {
+        map.try_emplace(keys[i], Entry{keys[i], i});
+    }
+
+    auto moved = 0;
+    for (auto i = 1; i < 100; i += 2) {
+        moved += &map.at(keys[i]) != addresses[i];
+    }
+
+    CHECK_EQ(moved, 0);
+    CHECK_EQ(map.get("Key1"), addresses[1]);
+    CHECK_EQ(map.get("Key0"), nullptr);
+    CHECK_EQ(map.size(), 150);
+    CHECK_EQ(map.begin()->first, "Key1");
+    CHECK_EQ(map.begin()[50].first, "Key100");
+    CHECK_EQ(map.at("Key199").value<int>(), 199);
+}
+
+TEST_CASE("Copy and move an EntryMap")
+{
+    auto resource = std::pmr::monotonic_buffer_resource{};
+    EntryMap map{&resource};
+    for (const auto key : {"A"sv, "B"sv, "C"sv}) {
+        map.try_emplace(key, Entry{key, 1});
+    }
+
+    const auto entry = &map.at("B");
+
+    auto copy = map;
+    CHECK_EQ(copy.size(), 3);
+    CHECK_NE(&copy.at("B"), entry);
+    CHECK_EQ(copy.begin()[2].first, "C");
+
+    auto moved = std::move(map);
+    CHECK_EQ(&moved.at("B"), entry);
+
+    copy = std::move(moved);
+    CHECK_EQ(&copy.at("B"), entry);
+    CHECK_EQ(copy.size(), 3);
+}
+
+TEST_SUITE_END();
@@ -17,7 +17,10 @@
  */
 
 #include <doctest/doctest.h>
+#include <atomic>
+#include <limits>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include <cppIni/Entry.h>
@@ -56,7 +59,7 @@ template<>
 auto Entry::value<DataStructure>() const -> DataStructure
 {
     std::vector<std::string> splitValues;
-    std::istringstream stream{m_data};
+    std::istringstream stream{std::string(data())};
     for (std::string line; std::getline(stream, line, ' ');) {
         splitValues.push_back(line);
     }
@@ -238,6 +241,114 @@ TEST_CASE("Changing the value of an Element with a std::string")
     CHECK_EQ(e.value<std::string>(), valueObject2);
 }
 
+TEST_CASE("Convert boolean literals")
+{
+    for (const auto literal : {"1", "true", "TRUE", "Yes", "on", " true\r"}) {
+        CHECK(Entry("Key", literal).value<bool>());
+    }
+
+    for (const auto literal : {"0", "false", "No", "off"}) {
+        CHECK_FALSE(Entry("Key", literal).value<bool>());
+    }
+
+    CHECK_FALSE(Entry("Key", "maybe").tryValue<bool>());
+}
+
+TEST_CASE("Convert numbers with surrounding whitespace, signs and hexadecimal notation")
+{
+    CHECK_EQ(Entry("Key", " 42\r").value<int>(), 42);
+    CHECK_EQ(Entry("Key", "+42").value<int>(), 42);
+    CHECK_EQ(Entry("Key", "-42").value<long long>(), -42);
+    CHECK_EQ(Entry("Key", "0xff").value<unsigned char>(), 255);
+    CHECK_EQ(Entry("Key", "1e3").value<double>(), 1000.);
+    CHECK_EQ(Entry("Key", "-0.5").value<float>(), -0.5f);
+}
+
+TEST_CASE("Values that do not fit into the type are reported")
+{
+    const Entry e{"Key", "300"};
+
+    CHECK_EQ(e.tryValue<unsigned char>(), std::nullopt);
+    CHECK_EQ(e.tryValue<short>(), 300);
+    CHECK_THROWS_AS(e.value<unsigned char>(), std::out_of_range);
+    CHECK_THROWS_AS(Entry("Key", "-1").value<unsigned int>(), std::invalid_argument);
+    CHECK_THROWS_AS(Entry("Key", "99999999999999999999").value<long long>(), std::out_of_range);
+}
+
+TEST_CASE("Malformed values are reported")
+{
+    for (const auto text : {"", "abc", "42abc", "4 2", "+-1", "0x"}) {
+        const Entry e{"Key", text};
+        CHECK_EQ(e.tryValue<int>(), std::nullopt);
+        CHECK_EQ(e.tryValue<double>(), std::nullopt);
+        CHECK_THROWS_AS(e.value<int>(), std::invalid_argument);
+    }
+
+    CHECK_EQ(Entry("Key", "abc").tryValue<std::string_view>(), "abc");
+}
+
+TEST_CASE_TEMPLATE("Arithmetic values survive a round trip", T, bool, unsigned char, long long, float, double, long double)
+{
+    for (const auto value : {T(0), T(1), std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()}) {
+        CHECK_EQ(Entry("Key", value).template value<T>(), value);
+    }
+}
+
+TEST_CASE("Floating point values are written in the shortest form")
+{
+    CHECK_EQ(Entry("Key", 3.14).data(), "3.14");
+    CHECK_EQ(Entry("Key", 0.1f).data(), "0.1");
+    CHECK_EQ(Entry("Key", true).data(), "1");
+}
+
+TEST_CASE("Cached values follow changes of the value")
+{
+    Entry e{"Key", 42};
+
+    CHECK_EQ(e.value<int>(), 42);
+    CHECK_EQ(e.value<int>(), 42);
+    CHECK_EQ(e.value<double>(), 42.);
+    CHECK_EQ(e.value<int>(), 42);
+
+    e.setData(1337);
+    CHECK_EQ(e.value<int>(), 1337);
+
+    e = "0x10";
+    CHECK_EQ(e.tryValue<int>(), 16);
+
+    e.setData(std::string("-1"));
+    CHECK_EQ(e.value<int>(), -1);
+    CHECK_EQ(e.tryValue<unsigned int>(), std::nullopt);
+
+    const Entry copy{e};
+    e = Entry{"Key", 7};
+    CHECK_EQ(e.value<int>(), 7);
+    CHECK_EQ(copy.value<int>(), -1);
+}
+
+TEST_CASE("Concurrent reads of cached values")
+{
+    const Entry e{"Key", 42};
+    std::atomic<int> mismatches{0};
+
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < 4; ++t) {
+        threads.emplace_back([&e, &mismatches, t] {
+            for (auto i = 0; i < 10'000; ++i) {
+                if ((i + t) % 2 ? e.value<int>() != 42 : e.value<double>() != 42.) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK_EQ(mismatches.load(), 0);
+}
+
 #if 0
 #if __has_include("windows.h")
 
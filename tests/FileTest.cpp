@@ -20,13 +20,167 @@
 
 #include <doctest/doctest.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
 #include <cppIni/File.h>
 #include "utils.h"
 
 using namespace std::literals;
 
+std::atomic<std::size_t> utils::allocations{0};
+
+/// \brief Counts an allocation and takes its memory from malloc
+/// \details Every form of operator new and operator delete is replaced, so memory is never allocated by one
+/// implementation and freed by another.
+static auto allocate(std::size_t size) noexcept -> void*
+{
+    ++utils::allocations;
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+/// \brief Counts an allocation and takes its memory from aligned_alloc
+static auto allocate(std::size_t size, std::align_val_t alignment) noexcept -> void*
+{
+    ++utils::allocations;
+
+    // aligned_alloc requires the size to be a multiple of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    return std::aligned_alloc(align, ((size == 0 ? 1 : size) + align - 1) / align * align);
+}
+
+void* operator new(std::size_t size)
+{
+    if (const auto memory = allocate(size)) {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (const auto memory = allocate(size, alignment)) {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
 static const std::string fileName = std::format("{}{}", WORKING_DIR, "/res/test.ini");
 
+static auto writeFile(const std::string& name, std::string_view content) -> void
+{
+    std::ofstream{name, std::ios::binary} << content;
+}
+
+static auto readFile(const std::string& name) -> std::string
+{
+    auto file = std::ifstream{name, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
 TEST_SUITE_BEGIN("File");
 
 TEST_CASE("Failing construction of an empty File object")
@@ -55,6 +209,32 @@ TEST_CASE("Successful parse of test.ini")
     CHECK(f.get<bool>("Section1.Subsection2.Subsubsection1", "BoolEntry"));
 }
 
+TEST_CASE("Successful parse of test.ini with a memory mapping")
+{
+    const auto f = File{fileName, {.loadMode = LoadMode::Mapped}};
+
+    REQUIRE_GT(f.sections().size(), 0);
+    CHECK(f.findSection("Section1.Subsection1"));
+    CHECK_EQ(f.findEntry("Section1.Entry1")->value<std::string_view>(), "Value1"sv);
+    CHECK_EQ(f.get<int>("Section1", "IntEntry"), 42);
+    CHECK_EQ(f.get<double>("Section1.Subsection1", "DoubleEntry"), 3.1415);
+    CHECK_EQ(f.get<std::string_view>("Section1.Subsection2", "StringEntry"), "Hello World!"sv);
+    CHECK(f.get<bool>("Section1.Subsection2.Subsubsection1", "BoolEntry"));
+}
+
+TEST_CASE("Mapped and streamed files are equal")
+{
+    const auto streamed = File{fileName};
+    const auto mapped = File{fileName, {.loadMode = LoadMode::Mapped}};
+    CHECK_EQ(streamed, mapped);
+}
+
+TEST_CASE("Open a non-existing file with a memory mapping")
+{
+    const auto f = File{"nonExisting.ini", {.loadMode = LoadMode::Mapped}};
+    CHECK_EQ(f.sections().size(), 0);
+}
+
 TEST_CASE("Open file from static method")
 {
     REQUIRE_NOTHROW(const auto f = File::open(fileName));
@@ -76,6 +256,15 @@ TEST_CASE("Get the value of an entry that doesn't exist")
     CHECK_EQ(f.get<int>("Section1", "Entry2"), int());
 }
 
+TEST_CASE("Get the value of an entry without throwing")
+{
+    const auto f = File{fileName};
+    CHECK_EQ(f.tryGet<int>("Section1", "IntEntry"), 42);
+    CHECK_EQ(f.tryGet<int>("Section1", "Entry1"), std::nullopt);
+    CHECK_EQ(f.tryGet<int>("Section1", "Entry2"), std::nullopt);
+    CHECK_THROWS(f.get<int>("Section1", "Entry1"));
+}
+
 TEST_CASE("Create a section")
 {
     auto f = File{fileName};
@@ -94,6 +283,22 @@ TEST_CASE("Create a subsection of an existing and a non-existing Section")
     CHECK(f.findSection("Section2.Subsection1.Subsubsection1"));
 }
 
+TEST_CASE("Find sections in a file with many sections")
+{
+    auto f = File{fileName};
+
+    for (auto i = 0; i < 1000; ++i) {
+        f.getSection(std::format("Generated{}.Subsection", i));
+    }
+
+    const auto section = f.findSection("Generated500.Subsection");
+    REQUIRE(section);
+    CHECK_EQ(section->title(), "Subsection");
+    CHECK_EQ(section->parent(), f.findSection("Generated500"));
+    CHECK_EQ(f.getSection("Generated500.Subsection"), section);
+    CHECK_EQ(f.sections().size(), 4 + 2000);
+}
+
 TEST_CASE("Call findSection to get an existing Section")
 {
     const auto f = File{fileName};
@@ -126,6 +331,40 @@ TEST_CASE("Call findEntry with a non-existing section")
     CHECK_EQ(entry, nullptr);
 }
 
+TEST_CASE("Call findEntry with a section and a name")
+{
+    const auto f = File{fileName};
+    const auto entry = f.findEntry("Section1.Subsection1", "DoubleEntry");
+    REQUIRE(entry);
+    CHECK_EQ(entry, f.findEntry("Section1.Subsection1.DoubleEntry"));
+    CHECK_EQ(f.findEntry("Section1", "NonExisting"), nullptr);
+    CHECK_EQ(f.findEntry("NonExisting", "Entry1"), nullptr);
+    CHECK_EQ(f.findEntry("Entry1"), nullptr);
+}
+
+TEST_CASE_TEMPLATE("Lookups do not allocate", T, std::integral_constant<LoadMode, LoadMode::Stream>, std::integral_constant<LoadMode, LoadMode::Mapped>)
+{
+    const auto f = File{fileName, {.loadMode = T::value}};
+
+    const utils::AllocationCounter counter;
+
+    const auto section = f.findSection("Section1.Subsection2.Subsubsection1");
+    const auto entry = f.findEntry("Section1.Subsection1.DoubleEntry");
+    const auto entry2 = f.findEntry("Section1", "IntEntry");
+    const auto missing = f.findEntry("Section1", "NonExisting");
+    const auto value = f.get<std::string_view>("Section1.Subsection2", "StringEntry");
+    const auto number = f.get<int>("Section1", "IntEntry");
+
+    CHECK_EQ(counter.count(), 0);
+
+    CHECK(section);
+    CHECK(entry);
+    CHECK(entry2);
+    CHECK_FALSE(missing);
+    CHECK_EQ(value, "Hello World!"sv);
+    CHECK_EQ(number, 42);
+}
+
 TEST_CASE("Equality operator")
 {
     const auto f = File{fileName};
@@ -146,6 +385,1147 @@ TEST_CASE("Change a value with set")
     CHECK_EQ(f.get<std::string_view>("Section1", "Entry1"), newValue);
 }
 
+TEST_CASE("Change a value of a mapped file with set")
+{
+    constexpr auto newValue = "NewValue"sv;
+
+    utils::TempFile tmpFile(fileName);
+    auto f = File{tmpFile.filename(), {.loadMode = LoadMode::Mapped}};
+    f.set("Section1", "Entry1", "NewValue");
+    CHECK_EQ(f.get<std::string_view>("Section1", "Entry1"), newValue);
+    CHECK_EQ(f.get<int>("Section1", "IntEntry"), 42);
+
+    const auto f2 = File{tmpFile.filename(), {.loadMode = LoadMode::Mapped}};
+    CHECK_EQ(f2.get<std::string_view>("Section1", "Entry1"), newValue);
+    CHECK_EQ(f2, f);
+}
+
+TEST_CASE("Change several values with a batch")
+{
+    utils::TempFile tmpFile(fileName);
+    auto f = File{tmpFile.filename()};
+
+    {
+        auto batch = f.batch();
+        batch.set("Section1", "Entry1", "NewValue").set("Section1", "IntEntry", 1337).set("Section3", "BoolEntry", true);
+        CHECK_EQ(batch.size(), 3);
+        CHECK_EQ(f.get<std::string_view>("Section1", "Entry1"), "Value1"sv);
+        CHECK_EQ(File{tmpFile.filename()}, File{fileName});
+
+        batch.commit();
+        CHECK_EQ(batch.size(), 0);
+    }
+
+    CHECK_EQ(f.get<std::string_view>("Section1", "Entry1"), "NewValue"sv);
+    CHECK_EQ(f.get<int>("Section1", "IntEntry"), 1337);
+    CHECK(f.get<bool>("Section3", "BoolEntry"));
+    CHECK_EQ(File{tmpFile.filename()}, f);
+}
+
+TEST_CASE("Uncommitted batches are discarded")
+{
+    utils::TempFile tmpFile(fileName);
+    auto f = File{tmpFile.filename()};
+
+    f.batch().set("Section1", "Entry1", "NewValue");
+
+    CHECK_EQ(f.get<std::string_view>("Section1", "Entry1"), "Value1"sv);
+    CHECK_EQ(File{tmpFile.filename()}, File{fileName});
+}
+
+TEST_CASE("Change a range of values with setMany")
+{
+    utils::TempFile tmpFile(fileName);
+    auto f = File{tmpFile.filename()};
+
+    const std::vector<std::tuple<std::string, std::string, int>> changes {
+        {"Section1", "IntEntry", 1},
+        {"Section1.Subsection1", "NewEntry", 2},
+        {"Section4", "IntEntry", 3},
+    };
+    f.setMany(changes);
+
+    CHECK_EQ(f.get<int>("Section1", "IntEntry"), 1);
+    CHECK_EQ(f.get<int>("Section1.Subsection1", "NewEntry"), 2);
+    CHECK_EQ(f.get<int>("Section4", "IntEntry"), 3);
+    CHECK_EQ(File{tmpFile.filename()}, f);
+}
+
+TEST_CASE("Disable auto flush")
+{
+    utils::TempFile tmpFile(fileName);
+    auto f = File{tmpFile.filename(), {.autoFlush = false}};
+    REQUIRE_FALSE(f.autoFlush());
+
+    f.set("Section1", "IntEntry", 1337);
+    CHECK_EQ(f.get<int>("Section1", "IntEntry"), 1337);
+    CHECK_EQ(File{tmpFile.filename()}.get<int>("Section1", "IntEntry"), 42);
+
+    f.flush();
+    CHECK_EQ(File{tmpFile.filename()}.get<int>("Section1", "IntEntry"), 1337);
+
+    f.setAutoFlush(true);
+    f.set("Section1", "IntEntry", 7);
+    CHECK_EQ(File{tmpFile.filename()}.get<int>("Section1", "IntEntry"), 7);
+}
+
+TEST_CASE_TEMPLATE("Flush keeps the layout of the file", T, std::integral_constant<LoadMode, LoadMode::Stream>, std::integral_constant<LoadMode, LoadMode::Mapped>,
+                   std::integral_constant<LoadMode, LoadMode::Lazy>)
+{
+    constexpr auto testFileName = "testPatch.ini";
+    writeFile(testFileName, "[Section1]\nEntry1=Value1\nShort=1\n; a comment\nLast=end\n\n[Section2]\nKey=Value\n");
+
+    {
+        auto f = File{testFileName, {.loadMode = T::value}};
+
+        f.set("Section1", "Short", 2);
+        CHECK_EQ(readFile(testFileName), "[Section1]\nEntry1=Value1\nShort=2\n; a comment\nLast=end\n\n[Section2]\nKey=Value\n");
+
+        f.set("Section1", "Short", 12345);
+        CHECK_EQ(readFile(testFileName), "[Section1]\nEntry1=Value1\nShort=12345\n; a comment\nLast=end\n\n[Section2]\nKey=Value\n");
+
+        f.set("Section1", "New", "x");
+        CHECK_EQ(readFile(testFileName), "[Section1]\nEntry1=Value1\nShort=12345\n; a comment\nLast=end\nNew=x\n\n[Section2]\nKey=Value\n");
+
+        f.set("Section2", "Key", "V");
+        CHECK_EQ(readFile(testFileName), "[Section1]\nEntry1=Value1\nShort=12345\n; a comment\nLast=end\nNew=x\n\n[Section2]\nKey=V\n");
+
+        f.set("Section3.Subsection", "A", 1);
+        CHECK_EQ(readFile(testFileName), "[Section1]\nEntry1=Value1\nShort=12345\n; a comment\nLast=end\nNew=x\n\n[Section2]\nKey=V\n"
+                                         "[Section3]\n\n[Section3.Subsection]\nA=1\n\n");
+
+        f.batch().set("Section1", "New", "y").set("Section2", "Key", "Value2").set("Section1", "Short", 0).commit();
+        CHECK_EQ(readFile(testFileName), "[Section1]\nEntry1=Value1\nShort=0\n; a comment\nLast=end\nNew=y\n\n[Section2]\nKey=Value2\n"
+                                         "[Section3]\n\n[Section3.Subsection]\nA=1\n\n");
+
+        CHECK_EQ(File{testFileName}, f);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Insert into the last Section and append a Section with one flush")
+{
+    const auto testFileName = std::string{"testLast.ini"};
+    writeFile(testFileName, "[Section1]\nA=1\n");
+
+    {
+        auto f = File{testFileName, {.autoFlush = false}};
+        f.set("Section2", "B", 2);
+        f.set("Section1", "C", 3);
+        f.flush();
+        CHECK_EQ(readFile(testFileName), "[Section1]\nA=1\nC=3\n[Section2]\nB=2\n\n");
+
+        f.set("Section1", "D", 4);
+        f.flush();
+        CHECK_EQ(readFile(testFileName), "[Section1]\nA=1\nC=3\nD=4\n[Section2]\nB=2\n\n");
+        CHECK_EQ(File{testFileName}, f);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Flush a file without a line break at the end")
+{
+    constexpr auto testFileName = "testPatch.ini";
+    writeFile(testFileName, "[Section]\nA=1");
+
+    {
+        auto f = File{testFileName};
+
+        f.set("Section", "B", 2);
+        CHECK_EQ(readFile(testFileName), "[Section]\nA=1\nB=2\n");
+
+        f.set("Section", "A", 100);
+        CHECK_EQ(readFile(testFileName), "[Section]\nA=100\nB=2\n");
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Append a Section and insert into the last one of a file without a line break at the end")
+{
+    constexpr auto testFileName = "testPatchEnd.ini";
+
+    for (const auto content : {"[A]\nX=1"sv, "[A]\nX=1\n; comment"sv}) {
+        writeFile(testFileName, content);
+
+        {
+            auto f = File{testFileName};
+            f.set("B", "Y", 2);
+            f.set("A", "Z", 3);
+            CHECK_EQ(readFile(testFileName), std::string{content} + "\nZ=3\n[B]\nY=2\n\n");
+        }
+
+        const auto reopened = File{testFileName};
+        CHECK_EQ(reopened.get<int>("A", "X"), 1);
+        CHECK_EQ(reopened.get<int>("A", "Z"), 3);
+        CHECK_EQ(reopened.get<int>("B", "Y"), 2);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("A file changed by someone else is written again instead of being patched")
+{
+    constexpr auto testFileName = "testPatchChanged.ini";
+    writeFile(testFileName, "[A]\nX=1\nY=2\n");
+
+    {
+        auto f = File{testFileName};
+
+        // Same size, so only the write time tells the change apart
+        writeFile(testFileName, "[A]\nY=2\nX=1\n");
+        std::filesystem::last_write_time(testFileName, std::filesystem::last_write_time(testFileName) + 1s);
+
+        f.set("A", "X", 5);
+        CHECK_EQ(readFile(testFileName), "[A]\nX=5\nY=2\n\n");
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Pointers to entries stay valid when keys are added to their Section")
+{
+    constexpr auto testFileName = "testStable.ini";
+    writeFile(testFileName, "[A]\nX=1\n");
+
+    {
+        auto f = File{testFileName, {.autoFlush = false}};
+        const auto entry = f.findEntry("A", "X");
+
+        for (auto i = 0; i < 100; ++i) {
+            f.set("A", std::format("Key{}", i), i);
+        }
+        f.set("A", "X", 2);
+
+        CHECK_EQ(f.findEntry("A", "X"), entry);
+        CHECK_EQ(entry->value<int>(), 2);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Changes through getSection rewrite the whole file")
+{
+    constexpr auto testFileName = "testPatch.ini";
+    writeFile(testFileName, "[Section]\nA=1\n");
+
+    {
+        auto f = File{testFileName};
+
+        f.getSection("Section")->setEntry({"B", 2});
+        f.flush();
+        CHECK_EQ(File{testFileName}.get<int>("Section", "B"), 2);
+
+        f.set("Section", "A", 3);
+        CHECK_EQ(File{testFileName}, f);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Atomic flush replaces the whole file")
+{
+    constexpr auto testFileName = "testAtomic.ini";
+    writeFile(testFileName, "[Section]\n; a comment\nA=1\n");
+
+    {
+        auto f = File{testFileName, {.flushMode = FlushMode::Atomic}};
+
+        f.set("Section", "A", 100);
+        f.set("Section", "B", 2);
+        f.set("Other", "C", 3);
+        CHECK_EQ(readFile(testFileName), "[Section]\n; a comment\nA=100\nB=2\n[Other]\nC=3\n\n");
+        CHECK_FALSE(std::filesystem::exists("testAtomic.ini.tmp"));
+
+        f.getSection("Section")->setEntry({"D", 4});
+        f.flush();
+        CHECK_EQ(File{testFileName}, f);
+        CHECK_FALSE(std::filesystem::exists("testAtomic.ini.tmp"));
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Atomic flush reports errors")
+{
+    auto f = File{"missing/directory/test.ini", {.flushMode = FlushMode::Atomic}};
+    CHECK_THROWS_AS(f.set("Section", "A", 1), std::system_error);
+    CHECK_FALSE(std::filesystem::exists("missing"));
+}
+
+TEST_CASE("Load a file into an arena")
+{
+    constexpr auto testFileName = "testArena.ini";
+    {
+        std::ofstream file{testFileName};
+        for (auto section = 0; section < 50; ++section) {
+            file << "[Section" << section << "]\n";
+            for (auto entry = 0; entry < 100; ++entry) {
+                file << "Key" << entry << "=Some value of entry " << section * entry << "\n";
+            }
+        }
+    }
+
+    auto heapAllocations = std::size_t{0};
+    auto arenaAllocations = std::size_t{0};
+
+    {
+        const auto counter = utils::AllocationCounter{};
+        const File f{testFileName};
+        heapAllocations = counter.count();
+    }
+
+    {
+        const auto counter = utils::AllocationCounter{};
+        const File f{testFileName, {.arena = true}};
+        arenaAllocations = counter.count();
+
+        CHECK_EQ(f, File{testFileName});
+        CHECK_EQ(f.get<std::string_view>("Section7", "Key3"), "Some value of entry 21"sv);
+    }
+
+    CHECK_LT(arenaAllocations, 100);
+    CHECK_LT(arenaAllocations * 20, heapAllocations);
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Change values of a file in an arena", T, std::integral_constant<LoadMode, LoadMode::Stream>, std::integral_constant<LoadMode, LoadMode::Mapped>,
+                   std::integral_constant<LoadMode, LoadMode::Lazy>)
+{
+    utils::TempFile tmpFile(fileName);
+
+    {
+        auto f = File{tmpFile.filename(), {.loadMode = T::value, .arena = true}};
+
+        f.set("Section1", "Entry1", "A longer value than before");
+        f.batch().set("Section1", "IntEntry", 7).set("Section4", "NewEntry", 3.5).commit();
+
+        CHECK_EQ(f.get<std::string_view>("Section1", "Entry1"), "A longer value than before"sv);
+        CHECK_EQ(File{tmpFile.filename()}, f);
+    }
+
+    {
+        auto f = File{tmpFile.filename(), {.arena = true}};
+        f.getSection("Section1")->setEntry({"Owned", std::string(100, 'x')});
+
+        CHECK_EQ(f.get<std::string>("Section1", "Owned"), std::string(100, 'x'));
+    }
+}
+
+TEST_CASE("Load a file from its binary cache")
+{
+    const auto testFileName = std::string{"testCache.ini"};
+    {
+        std::ofstream file{testFileName, std::ios::binary};
+        for (auto section = 0; section < 50; ++section) {
+            file << "[Section" << section << "]\n; a comment\n";
+            for (auto entry = 0; entry < 100; ++entry) {
+                file << "Key" << entry << "=Some value of entry " << section * entry << "\n";
+            }
+            file << "[.Sub]\nKey=" << section << "\n\n";
+        }
+    }
+
+    auto parseAllocations = std::size_t{0};
+    auto cacheAllocations = std::size_t{0};
+
+    {
+        const auto counter = utils::AllocationCounter{};
+        const File f{testFileName, {.cache = true}};
+        parseAllocations = counter.count();
+    }
+
+    REQUIRE(std::filesystem::exists(testFileName + ".cache"));
+
+    {
+        const auto counter = utils::AllocationCounter{};
+        auto f = File{testFileName, {.cache = true}};
+        cacheAllocations = counter.count();
+
+        CHECK_EQ(f, File{testFileName});
+        CHECK_EQ(f.sections().size(), 100);
+        CHECK_EQ(f.get<std::string_view>("Section7", "Key3"), "Some value of entry 21"sv);
+        CHECK_EQ(f.get<int>("Section42.Sub", "Key"), 42);
+        CHECK_EQ(f.findSection("Section42.Sub")->parent(), f.findSection("Section42"));
+
+        f.set("Section3", "Key5", "changed");
+        f.set("Section3.Sub", "New", 1);
+    }
+
+    CHECK_LT(cacheAllocations * 10, parseAllocations);
+
+    const auto patched = readFile(testFileName);
+    CHECK_NE(patched.find("; a comment\nKey0=Some value of entry 0\n"), std::string::npos);
+    CHECK_NE(patched.find("Key5=changed\n"), std::string::npos);
+    CHECK_NE(patched.find("[.Sub]\nKey=3\nNew=1\n\n[Section4]"), std::string::npos);
+    const auto reloaded = File{testFileName, {.cache = true}};
+    CHECK_EQ(reloaded.get<std::string_view>("Section3", "Key5"), "changed"sv);
+
+    std::filesystem::remove(testFileName);
+    std::filesystem::remove(testFileName + ".cache");
+}
+
+TEST_CASE("A stale or damaged cache is not used")
+{
+    const auto testFileName = std::string{"testCache.ini"};
+    const auto cacheFileName = testFileName + ".cache";
+    const auto load = [&testFileName] { return File{testFileName, {.cache = true}}.get<int>("Section", "A"); };
+
+    writeFile(testFileName, "[Section]\nA=1\n");
+    CHECK_EQ(load(), 1);
+
+    // Same size and write time, but different content
+    const auto time = std::filesystem::last_write_time(testFileName);
+    writeFile(testFileName, "[Section]\nA=2\n");
+    std::filesystem::last_write_time(testFileName, time);
+    CHECK_EQ(load(), 2);
+
+    auto cache = readFile(cacheFileName);
+    cache[cache.size() - 2] ^= 1;
+    writeFile(cacheFileName, cache);
+    CHECK_EQ(load(), 2);
+    CHECK_NE(readFile(cacheFileName), cache);
+
+    writeFile(cacheFileName, cache.substr(0, 20));
+    CHECK_EQ(load(), 2);
+
+    std::filesystem::remove(testFileName);
+    std::filesystem::remove(cacheFileName);
+}
+
+TEST_CASE("Write the cache after changes were flushed")
+{
+    const auto testFileName = std::string{"testCache.ini"};
+    writeFile(testFileName, "[Section]\nA=1");
+
+    {
+        auto f = File{testFileName, {.autoFlush = false}};
+        f.set("Section", "A", 100);
+        f.set("Other", "B", 2);
+        CHECK_THROWS_AS(f.writeCache(), std::logic_error);
+
+        f.flush();
+        CHECK_NOTHROW(f.writeCache());
+    }
+
+    {
+        const auto f = File{testFileName, {.cache = true}};
+        CHECK_EQ(f.get<int>("Section", "A"), 100);
+        CHECK_EQ(f.get<int>("Other", "B"), 2);
+        CHECK_EQ(f, File{testFileName});
+    }
+
+    std::filesystem::remove(testFileName);
+    std::filesystem::remove(testFileName + ".cache");
+    CHECK_THROWS_AS(File{testFileName}.writeCache(), std::system_error);
+}
+
+TEST_CASE("Do not write the cache of a file that was changed by someone else with the same size")
+{
+    const auto testFileName = std::string{"testCacheStale.ini"};
+    writeFile(testFileName, "[Section]\nA=1\n");
+
+    const auto f = File{testFileName};
+    const auto time = std::filesystem::last_write_time(testFileName);
+    writeFile(testFileName, "[Section]\nA=2\n");
+    std::filesystem::last_write_time(testFileName, time + std::chrono::seconds{1});
+
+    CHECK_THROWS_AS(f.writeCache(), std::system_error);
+    CHECK_FALSE(std::filesystem::exists(testFileName + ".cache"));
+    const auto reloaded = File{testFileName, {.cache = true}};
+    CHECK_EQ(reloaded.get<int>("Section", "A"), 2);
+
+    std::filesystem::remove(testFileName);
+    std::filesystem::remove(testFileName + ".cache");
+}
+
+TEST_CASE("Read and change a thread-safe File from several threads")
+{
+    constexpr auto testFileName = "testThreads.ini";
+    constexpr auto writers = 4;
+    constexpr auto readers = 4;
+    constexpr auto rounds = 200;
+    writeFile(testFileName, "[Shared]\nCounter=0\n");
+
+    {
+        auto f = File{testFileName, {.autoFlush = false, .threadSafe = true}};
+        std::atomic<bool> done {false};
+        std::atomic<int> errors {0};
+        std::vector<std::thread> threads;
+
+        for (auto writer = 0; writer < writers; ++writer) {
+            threads.emplace_back([&f, writer] {
+                for (auto i = 0; i < rounds; ++i) {
+                    f.set(std::format("Writer{}", writer), std::format("Key{}", i % 20), i);
+                    f.set(std::format("Writer{}.Sub{}", writer, i % 5), "Value", std::to_string(i));
+                    f.batch().set("Shared", std::format("Key{}", writer), i).set("Shared", "Last", writer).commit();
+
+                    if (i % 50 == 0) {
+                        f.flush();
+                    }
+                }
+            });
+        }
+
+        for (auto reader = 0; reader < readers; ++reader) {
+            threads.emplace_back([&f, &done, &errors] {
+                while (not done) {
+                    for (auto writer = 0; writer < writers; ++writer) {
+                        const auto section = std::format("Writer{}", writer);
+                        const auto number = f.tryGet<int>(section, "Key0");
+                        const auto text = f.get<std::string>(section + ".Sub0", "Value");
+
+                        if ((number and (*number < 0 or *number >= rounds)) or (not text.empty() and std::stoi(text) % 5 != 0)) {
+                            ++errors;
+                        }
+
+                        if (const auto sub = f.findSection(section + ".Sub0"); sub and sub->parent() != f.findSection(section)) {
+                            ++errors;
+                        }
+                    }
+                }
+            });
+        }
+
+        for (auto writer = 0; writer < writers; ++writer) {
+            threads[writer].join();
+        }
+        done = true;
+        for (auto reader = 0; reader < readers; ++reader) {
+            threads[writers + reader].join();
+        }
+
+        f.flush();
+
+        CHECK_EQ(errors.load(), 0);
+        for (auto writer = 0; writer < writers; ++writer) {
+            CHECK_EQ(f.get<int>(std::format("Writer{}", writer), "Key19"), rounds - 1);
+            CHECK_EQ(f.get<int>(std::format("Writer{}.Sub4", writer), "Value"), rounds - 1);
+            CHECK_EQ(f.get<int>("Shared", std::format("Key{}", writer)), rounds - 1);
+        }
+        CHECK_EQ(f.sections().size(), 1 + writers * 6);
+        CHECK_EQ(File{testFileName}, f);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Reload a changed file", T, std::integral_constant<LoadMode, LoadMode::Stream>, std::integral_constant<LoadMode, LoadMode::Mapped>,
+                   std::integral_constant<LoadMode, LoadMode::Lazy>)
+{
+    constexpr auto testFileName = "testReload.ini";
+    writeFile(testFileName, "[A]\nX=1\nY=2\n[B]\nZ=3\n[C]\nW=4\n[F]\nP=1\nQ=2\n");
+
+    {
+        auto f = File{testFileName, {.loadMode = T::value}};
+        const auto a = f.findSection("A");
+        const auto x = f.findEntry("A", "X");
+        const auto y = f.findEntry("A", "Y");
+        const auto z = f.findEntry("B", "Z");
+        const auto text = x->data().data();
+        CHECK_EQ(f.get<int>("A", "Y"), 2);
+
+        // A mapped file must not be rewritten in place, so it is replaced like editors do
+        writeFile(testFileName + ".new"s, "[A]\nX=1\nY=20\n[B]\nZ=3\n[D]\nV=6\n[F]\nQ=2\n");
+        std::filesystem::rename(testFileName + ".new"s, testFileName);
+        f.reload();
+
+        CHECK_EQ(f.findSection("A"), a);
+        CHECK_EQ(f.findEntry("A", "X"), x);
+        CHECK_EQ(f.findEntry("A", "Y"), y);
+        CHECK_EQ(f.findEntry("B", "Z"), z);
+        CHECK_EQ(x->data().data(), text);
+        CHECK_EQ(f.get<int>("A", "Y"), 20);
+        CHECK_EQ(f.get<int>("B", "Z"), 3);
+        CHECK_EQ(f.findSection("C"), nullptr);
+        CHECK_EQ(f.get<int>("D", "V"), 6);
+        CHECK_EQ(f.findEntry("F", "P"), nullptr);
+        CHECK_EQ(f.get<int>("F", "Q"), 2);
+        CHECK_EQ(f.sections().size(), 4);
+        CHECK_EQ(f, File{testFileName});
+
+        f.set("A", "X", 7);
+        f.set("F", "R", 8);
+        CHECK_EQ(readFile(testFileName), "[A]\nX=7\nY=20\n[B]\nZ=3\n[D]\nV=6\n[F]\nQ=2\nR=8\n");
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Entries keep their address when a reload adds and removes keys of their Section", T,
+                   std::integral_constant<LoadMode, LoadMode::Stream>, std::integral_constant<LoadMode, LoadMode::Mapped>)
+{
+    constexpr auto testFileName = "testReloadStable.ini";
+    writeFile(testFileName, "[S]\nA=1\nR=0\nZ=26\n");
+
+    {
+        File f = File{testFileName, {.loadMode = T::value}};
+        const auto a = f.findEntry("S", "A");
+        const auto z = f.findEntry("S", "Z");
+
+        writeFile(testFileName + ".new"s, "[S]\nB=2\nA=1\nC=3\nD=4\nZ=26\nE=5\n");
+        std::filesystem::rename(testFileName + ".new"s, testFileName);
+        f.reload();
+
+        CHECK_EQ(f.findEntry("S", "A"), a);
+        CHECK_EQ(f.findEntry("S", "Z"), z);
+        CHECK_EQ(f.findEntry("S", "R"), nullptr);
+        CHECK_EQ(a->value<int>(), 1);
+        CHECK_EQ(z->value<int>(), 26);
+        CHECK_EQ(f.get<int>("S", "E"), 5);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Compact a File that was reloaded", T, std::false_type, std::true_type)
+{
+    constexpr auto testFileName = "testCompact.ini";
+    writeFile(testFileName, "[A]\nX=0\n[B]\nY=2\n");
+
+    {
+        File f = File{testFileName, {.threadSafe = T::value}};
+        const auto a = f.findSection("A");
+        const auto x = f.keyHandle("A", "X");
+
+        for (auto i = 1; i <= 10; ++i) {
+            writeFile(testFileName, std::format("[A]\nX={}\n[C{}]\nZ=1\n", i, i));
+            f.reload();
+        }
+
+        const auto grown = f.stats().heapBytes;
+
+        // B and C1 to C9 were removed by the reloads
+        CHECK_EQ(f.compact(), 10);
+        CHECK_EQ(f.compact(), 0);
+        CHECK_LT(f.stats().heapBytes, grown);
+
+        CHECK_EQ(f.findSection("A"), a);
+        CHECK_EQ(x.get<int>(), 10);
+        CHECK_EQ(f.get<int>("C10", "Z"), 1);
+        CHECK_EQ(f.sections().size(), 2);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Opening a File again reloads it")
+{
+    constexpr auto testFileName = "testReload.ini";
+    writeFile(testFileName, "[A]\nX=1\n");
+
+    {
+        auto f = File{testFileName};
+        writeFile(testFileName, "[A]\nX=2\n");
+        f.open();
+
+        CHECK_EQ(f.sections().size(), 1);
+        CHECK_EQ(f.get<int>("A", "X"), 2);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Poll a file for changes", T, std::false_type, std::true_type)
+{
+    const auto testFileName = std::string{"testPoll.ini"};
+    writeFile(testFileName, "[A]\nX=1\n");
+
+    {
+        auto f = File{testFileName, {.watch = T::value}};
+#ifdef __linux__
+        CHECK_EQ(f.watchHandle() >= 0, T::value);
+#endif
+        CHECK_FALSE(f.poll());
+
+        f.set("A", "X", 100);
+        CHECK_FALSE(f.poll());
+        CHECK_EQ(f.get<int>("A", "X"), 100);
+
+        writeFile(testFileName, "[A]\nX=2\nY=3\n");
+        CHECK(f.poll());
+        CHECK_FALSE(f.poll());
+        CHECK_EQ(f.get<int>("A", "X"), 2);
+        CHECK_EQ(f.get<int>("A", "Y"), 3);
+
+        // Editors usually replace the file instead of writing it
+        writeFile(testFileName + ".new", "[A]\nX=4\n");
+        std::filesystem::rename(testFileName + ".new", testFileName);
+        CHECK(f.poll());
+        CHECK_EQ(f.get<int>("A", "X"), 4);
+        CHECK_EQ(f.findEntry("A", "Y"), nullptr);
+
+        std::filesystem::remove(testFileName);
+        CHECK_FALSE(f.poll());
+        CHECK_EQ(f.get<int>("A", "X"), 4);
+    }
+}
+
+TEST_CASE("Reload a thread-safe File while it is read")
+{
+    constexpr auto testFileName = "testReload.ini";
+    writeFile(testFileName, "[A]\nX=1\n");
+
+    auto f = File{testFileName, {.threadSafe = true}};
+    const auto section = f.findSection("A");
+    std::atomic<bool> done {false};
+    std::atomic<int> errors {0};
+    std::vector<std::thread> readers;
+
+    for (auto i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            while (not done) {
+                if (const auto x = f.get<int>("A", "X"); x != 1 and x != 22) {
+                    ++errors;
+                }
+
+                if (f.findSection("A") != section) {
+                    ++errors;
+                }
+            }
+        });
+    }
+
+    for (auto i = 0; i < 50; ++i) {
+        writeFile(testFileName, i % 2 ? "[A]\nX=1\n" : "[A]\nX=22\n[B]\nY=1\n");
+        f.reload();
+    }
+
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    CHECK_EQ(errors.load(), 0);
+    CHECK_EQ(f.get<int>("A", "X"), 1);
+    CHECK_EQ(f.findSection("B"), nullptr);
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Mapped and streamed files are parsed alike")
+{
+    constexpr auto testFileName = "testScan.ini";
+
+    // Lines of every length, so line breaks and separators fall on every position of a block
+    auto text = std::string{"[Section]\n"};
+    for (auto i = 0; i < 200; ++i) {
+        text += std::format("Key{}={}\n", i, std::string(static_cast<std::size_t>(i), i % 7 ? 'v' : '='));
+        text += i % 13 ? "" : "\n\n";
+        text += i % 17 ? "" : std::format("[Section.Sub{}]\nNoSeparator{}\n", i, i);
+    }
+    text += "Last=no line break";
+    writeFile(testFileName, text);
+
+    const auto streamed = File{testFileName, {.loadMode = LoadMode::Stream}};
+    const auto mapped = File{testFileName, {.loadMode = LoadMode::Mapped}};
+    const auto lazy = File{testFileName, {.loadMode = LoadMode::Lazy}};
+    CHECK_EQ(mapped, streamed);
+    CHECK_EQ(lazy, streamed);
+    CHECK_EQ(mapped.get<std::string>("Section.Sub68", "Key70"), std::string(70, '='));
+    CHECK_EQ(mapped.get<std::string>("Section.Sub17", "NoSeparator17"), "NoSeparator17");
+    CHECK_EQ(mapped.get<std::string>("Section.Sub187", "Last"), "no line break");
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Parse a mapped file on several threads")
+{
+    const auto sequentialName = std::string{"testSequential.ini"};
+    const auto parallelName = std::string{"testParallel.ini"};
+
+    // Large enough to be split, with relative titles and parents that are found in other chunks
+    auto text = std::string{};
+    for (auto i = 0; i < 6000; ++i) {
+        text += std::format("[Section{}]\n", i);
+        for (auto j = 0; j < 10; ++j) {
+            text += std::format("Key{}=Value {} {}\n", j, i, j);
+        }
+        text += std::format("[.Sub]\nKey=Relative {}\n\n", i);
+        text += std::format("[Section{}.Child]\nKey={}\nKey=Duplicate\n", i / 2, i);
+    }
+    text += "[Last]\nKey=No line break";
+
+    for (const auto arena : {false, true}) {
+        writeFile(sequentialName, text);
+        writeFile(parallelName, text);
+
+        {
+            auto sequential = File{sequentialName, {.loadMode = LoadMode::Mapped, .arena = arena}};
+            auto parallel = File{parallelName, {.loadMode = LoadMode::Mapped, .arena = arena, .parseThreads = 4}};
+
+            REQUIRE_EQ(parallel.sections().size(), sequential.sections().size());
+            CHECK_EQ(parallel, sequential);
+
+            for (std::size_t i = 0; i < parallel.sections().size(); ++i) {
+                const auto parent = parallel.sections()[i]->parent();
+                const auto expected = sequential.sections()[i]->parent();
+                REQUIRE_EQ(parent == nullptr, expected == nullptr);
+                CHECK_EQ(parallel.sections()[i]->fqTitle(), sequential.sections()[i]->fqTitle());
+
+                if (parent) {
+                    CHECK_EQ(parent->fqTitle(), expected->fqTitle());
+                }
+            }
+
+            CHECK_EQ(parallel.get<std::string>("Section4999.Sub", "Key"), "Relative 4999");
+            CHECK_EQ(parallel.get<std::string>("Section2999.Child", "Key"), "5998");
+            CHECK_EQ(parallel.get<std::string>("Last", "Key"), "No line break");
+
+            for (auto* f : {&sequential, &parallel}) {
+                f->set("Section3000", "Key5", "Changed");
+                f->set("Section5999.Sub", "New", 1);
+                f->set("Last", "Key", "Line break");
+            }
+
+            CHECK(readFile(parallelName) == readFile(sequentialName));
+        }
+    }
+
+    std::filesystem::remove(sequentialName);
+    std::filesystem::remove(parallelName);
+}
+
+TEST_CASE("Sections of a lazily loaded file are parsed on first access")
+{
+    constexpr auto testFileName = "testLazy.ini";
+
+    const auto generate = [](std::string_view first, std::string_view last, bool inserted) {
+        auto text = std::string{};
+        for (auto i = 0; i < 1000; ++i) {
+            const auto value = i == 0 ? std::string{first} : i == 999 ? std::string{last} : std::format("Value {}", i);
+            text += std::format("[Section{}]\nKey={}\nOther={}\n{}\n", i, value, i, inserted and i == 998 ? "New=1\n" : "");
+        }
+        return text;
+    };
+    writeFile(testFileName, generate("Value 0", "Value 999", false));
+
+    {
+        // Keys and short values are interned while they are parsed, so the pool shows which Sections were parsed
+        const auto pool = std::make_shared<StringPool>();
+        auto f = File{testFileName, {.loadMode = LoadMode::Lazy, .stringPool = pool}};
+        const auto titles = pool->size();
+
+        CHECK_EQ(f.get<std::string_view>("Section500", "Key"), "Value 500"sv);
+        CHECK_EQ(pool->size(), titles + 4);
+        CHECK_EQ(f.get<int>("Section500", "Other"), 500);
+        CHECK_EQ(pool->size(), titles + 4);
+        CHECK_LT(titles, 2 * 1000);
+
+        // Moves all Sections behind the first one before they were parsed
+        f.set("Section0", "Key", "A much longer value than before");
+        f.set("Section999", "Key", "Changed");
+        f.set("Section998", "New", 1);
+        CHECK_EQ(f.get<int>("Section700", "Other"), 700);
+    }
+
+    CHECK_EQ(readFile(testFileName), generate("A much longer value than before", "Changed", true));
+    CHECK_EQ(File(testFileName, {.loadMode = LoadMode::Lazy}), File{testFileName});
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Read a lazily loaded thread-safe File from several threads")
+{
+    constexpr auto testFileName = "testLazyThreads.ini";
+
+    auto text = std::string{};
+    for (auto i = 0; i < 200; ++i) {
+        text += std::format("[Section{}]\nKey={}\n[.Sub]\nValue=Text {}\n", i, i, i);
+    }
+    writeFile(testFileName, text);
+
+    {
+        auto f = File{testFileName, {.loadMode = LoadMode::Lazy, .autoFlush = false, .threadSafe = true}};
+        auto errors = std::atomic<int>{0};
+        auto threads = std::vector<std::jthread>{};
+
+        for (auto t = 0; t < 4; ++t) {
+            threads.emplace_back([&f, &errors, t] {
+                for (auto i = 0; i < 200; ++i) {
+                    const auto section = std::format("Section{}", (i + t * 50) % 200);
+
+                    if (f.get<int>(section, "Key") != (i + t * 50) % 200 or not f.findEntry(section + ".Sub", "Value")) {
+                        ++errors;
+                    }
+
+                    if (t == 0) {
+                        f.set(section, "Written", i);
+                    }
+                }
+            });
+        }
+
+        threads.clear();
+        CHECK_EQ(errors.load(), 0);
+        CHECK_EQ(f.get<std::string>("Section199.Sub", "Value"), "Text 199");
+        CHECK_EQ(f.get<int>("Section42", "Written"), 42);
+        CHECK_EQ(f.sections().size(), 400);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Key handles follow changes and reloads", T, std::integral_constant<LoadMode, LoadMode::Stream>, std::integral_constant<LoadMode, LoadMode::Mapped>,
+                   std::integral_constant<LoadMode, LoadMode::Lazy>)
+{
+    constexpr auto testFileName = "testHandles.ini";
+    writeFile(testFileName, "[A]\nX=1\nY=2\n[B]\nZ=3\n");
+
+    {
+        auto f = File{testFileName, {.loadMode = T::value}};
+        const auto x = f.keyHandle("A", "X");
+        const auto y = f.keyHandle("A", "Y");
+        const auto w = f.keyHandle("A", "W");
+        const auto b = f.sectionHandle("B");
+        const auto c = f.sectionHandle("C");
+
+        CHECK(x.exists());
+        CHECK_EQ(x.get<int>(), 1);
+        CHECK_EQ(x.entry(), f.findEntry("A", "X"));
+        CHECK_EQ(x.section().title(), "A");
+        CHECK_EQ(x.key(), "X");
+        CHECK_FALSE(w.exists());
+        CHECK_EQ(w.get<int>(), 0);
+        CHECK_EQ(b.get(), f.findSection("B"));
+        CHECK_FALSE(c.exists());
+        CHECK_FALSE(KeyHandle{}.exists());
+
+        // Growing the Section moves its entries, but not their positions
+        for (auto i = 0; i < 50; ++i) {
+            f.set("A", std::format("N{}", i), i);
+        }
+        f.set("A", "X", 10);
+        CHECK_EQ(x.get<int>(), 10);
+        CHECK_EQ(x.entry(), f.findEntry("A", "X"));
+        CHECK_EQ(y.get<int>(), 2);
+
+        f.set("A", "W", 5);
+        f.set("C", "V", 1);
+        CHECK_EQ(w.get<int>(), 5);
+        CHECK(c.exists());
+        CHECK_EQ(c.key("V").get<int>(), 1);
+
+        // Erasing X moves Y to the front of the Section
+        writeFile(testFileName + ".new"s, "[A]\nY=20\nW=5\n[C]\nV=1\n");
+        std::filesystem::rename(testFileName + ".new"s, testFileName);
+        f.reload();
+
+        CHECK_FALSE(x.exists());
+        CHECK_EQ(x.tryGet<int>(), std::nullopt);
+        CHECK_EQ(y.get<int>(), 20);
+        CHECK_EQ(y.entry(), f.findEntry("A", "Y"));
+        CHECK_EQ(w.get<int>(), 5);
+        CHECK_FALSE(b.exists());
+        CHECK_FALSE(b.key("Z").exists());
+
+        writeFile(testFileName + ".new"s, "[A]\nX=3\n[B]\nZ=4\n");
+        std::filesystem::rename(testFileName + ".new"s, testFileName);
+        f.reload();
+
+        CHECK_EQ(x.get<int>(), 3);
+        CHECK_FALSE(y.exists());
+        CHECK_EQ(b.get(), f.findSection("B"));
+        CHECK_EQ(b.key("Z").get<int>(), 4);
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Read key handles of a thread-safe File while it is changed and reloaded")
+{
+    constexpr auto testFileName = "testHandleThreads.ini";
+    writeFile(testFileName, "[A]\nX=1\n");
+
+    auto f = File{testFileName, {.autoFlush = false, .threadSafe = true}};
+    const auto x = f.keyHandle("A", "X");
+    std::atomic<bool> done {false};
+    std::atomic<int> errors {0};
+    std::vector<std::thread> threads;
+
+    for (auto i = 0; i < 2; ++i) {
+        // Every thread uses its own copy of the handle
+        threads.emplace_back([&, x] {
+            while (not done) {
+                if (const auto value = x.get<int>(); value != 1 and value != 22) {
+                    ++errors;
+                }
+            }
+        });
+    }
+
+    threads.emplace_back([&] {
+        for (auto i = 0; not done; ++i) {
+            f.set("A", std::format("N{}", i % 100), i);
+        }
+    });
+
+    for (auto i = 0; i < 50; ++i) {
+        writeFile(testFileName, i % 2 ? "[A]\nX=1\n" : "[A]\nW=0\nV=0\nX=22\n");
+        f.reload();
+    }
+
+    done = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK_EQ(errors.load(), 0);
+    CHECK_EQ(x.get<int>(), 1);
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Statistics count parsing, lookups and flushes", T, std::false_type, std::true_type)
+{
+    constexpr auto testFileName = "testStats.ini";
+    constexpr auto content = "[A]\nX=1\n\n[B]\nY=2\n"sv;
+    writeFile(testFileName, content);
+
+    {
+        auto f = File{testFileName, {.threadSafe = T::value}};
+        const auto opened = f.stats();
+
+        if constexpr (File::statisticsEnabled) {
+            CHECK_EQ(opened.bytesParsed, content.size());
+            CHECK_EQ(opened.lines, 5);
+            CHECK_EQ(opened.loads, 1);
+        }
+        CHECK_EQ(opened.sections, 2);
+        CHECK_EQ(opened.entries, 2);
+        CHECK_EQ(opened.flushes, 0);
+        CHECK_GT(opened.heapBytes, 0);
+
+        CHECK_EQ(f.get<int>("A", "X"), 1);
+        CHECK_EQ(f.tryGet<int>("B", "Y"), 2);
+        CHECK_EQ(f.get<int>("A", "Z"), 0);
+        CHECK_EQ(f.findEntry("C", "X"), nullptr);
+
+        f.set("A", "X", 3);
+        f.setAutoFlush(false);
+        f.set("B", "Long", std::string(1000, 'x'));
+        f.flush();
+
+        writeFile(testFileName, "[A]\nX=4\n");
+        f.reload();
+        const auto used = f.stats();
+
+        if constexpr (File::statisticsEnabled) {
+            CHECK_EQ(used.hits, 2);
+            CHECK_EQ(used.misses, 2);
+            CHECK_EQ(used.flushes, 2);
+            CHECK_EQ(used.autoFlushes, 1);
+            CHECK_EQ(used.loads, 2);
+            CHECK_EQ(used.lines, 7);
+            CHECK_GT(used.flushTime.count(), 0);
+        }
+        CHECK_EQ(used.sections, 1);
+        CHECK_EQ(used.entries, 1);
+    }
+
+    {
+        const auto mapped = File{testFileName, {.loadMode = LoadMode::Mapped}};
+        if constexpr (File::statisticsEnabled) {
+            CHECK_EQ(mapped.stats().lines, 2);
+            CHECK_EQ(mapped.stats().bytesParsed, 8);
+        }
+    }
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE_TEMPLATE("Read a File from memory", T, std::integral_constant<LoadMode, LoadMode::Stream>, std::integral_constant<LoadMode, LoadMode::Lazy>)
+{
+    const auto text = "[A]\nX=1\n[A.B]\nY=A value that is too long for a short string\n"s;
+    const auto inside = [](const std::string& buffer, std::string_view view) {
+        return view.data() >= buffer.data() and view.data() + view.size() <= buffer.data() + buffer.size();
+    };
+
+    const File borrowed = File::fromBuffer(std::string_view{text}, {.loadMode = T::value});
+    CHECK_EQ(borrowed.get<int>("A", "X"), 1);
+    CHECK(inside(text, borrowed.findEntry("A.B", "Y")->data()));
+    CHECK_EQ(borrowed.sections().size(), 2);
+
+    const auto bytes = std::vector<char>(text.begin(), text.end());
+    const File span = File::fromBuffer(std::span{bytes}, {.loadMode = T::value});
+    CHECK_EQ(span.get<int>("A", "X"), 1);
+    CHECK_EQ(span, borrowed);
+
+    auto owned = text;
+    const auto data = owned.data();
+    const File moved = File::fromString(std::move(owned), {.loadMode = T::value});
+    CHECK_EQ(moved.findEntry("A.B", "Y")->data().data(), data + text.find("A value"));
+
+    auto input = std::istringstream{"ignored\n" + text};
+    auto ignored = std::string{};
+    std::getline(input, ignored);
+    const File streamed = File::fromStream(input, {.loadMode = T::value});
+    CHECK_EQ(streamed, borrowed);
+}
+
+TEST_CASE("A File read from memory is changed in memory only")
+{
+    const auto text = "[A]\nX=1\n"sv;
+    auto f = File::fromBuffer(text);
+
+    f.set("A", "X", 2);
+    f.set("B", "Y", 3);
+    f.reload();
+    CHECK_FALSE(f.poll());
+
+    CHECK_EQ(f.get<int>("A", "X"), 2);
+    CHECK_EQ(f.get<int>("B", "Y"), 3);
+    CHECK_EQ(text, "[A]\nX=1\n");
+    CHECK_THROWS_AS(f.writeCache(), std::logic_error);
+    CHECK_THROWS_AS(f.open(), std::runtime_error);
+}
+
+TEST_CASE_TEMPLATE("Move a File without moving its Sections", T, std::false_type, std::true_type)
+{
+    static_assert(std::is_nothrow_move_constructible_v<File> and std::is_nothrow_move_assignable_v<File>);
+    static_assert(not std::is_copy_constructible_v<File> and not std::is_polymorphic_v<File>);
+
+    constexpr auto testFileName = "testMove.ini";
+    writeFile(testFileName, "[A]\nX=1\n[A.B]\nY=2\n");
+
+    File f = File::open(testFileName, {.arena = T::value, .threadSafe = T::value});
+    const auto section = f.findSection("A.B");
+    const auto entry = f.findEntry("A.B", "Y");
+
+    const auto counter = utils::AllocationCounter{};
+    File moved{std::move(f)};
+    CHECK_EQ(counter.count(), 0);
+    CHECK(f.sections().empty());
+
+    CHECK_EQ(moved.findSection("A.B"), section);
+    CHECK_EQ(moved.findEntry("A.B", "Y"), entry);
+    CHECK_EQ(section->parent(), moved.findSection("A"));
+    CHECK_EQ(entry->parent(), section);
+
+    moved.set("A", "X", 3);
+    f = std::move(moved);
+    CHECK_EQ(f.findSection("A.B"), section);
+    CHECK_EQ(f.get<int>("A", "X"), 3);
+    CHECK_EQ(File{testFileName}.get<int>("A", "X"), 3);
+
+    if constexpr (File::statisticsEnabled) {
+        CHECK_EQ(f.stats().loads, 1);
+        CHECK_EQ(f.stats().autoFlushes, 1);
+    }
+
+    // Assigning to a File that has Sections destroys them before their storage
+    f = File::fromString("[C]\nZ=4\n", {.arena = T::value, .threadSafe = T::value});
+    CHECK_EQ(f.findSection("A"), nullptr);
+    CHECK_EQ(f.get<int>("C", "Z"), 4);
+    f.set("C", "Z", 5);
+    CHECK_EQ(f.get<int>("C", "Z"), 5);
+
+    std::filesystem::remove(testFileName);
+}
+
 TEST_CASE("Write a file to disk")
 {
     constexpr auto testFileName = "testWrite.ini";
@@ -0,0 +1,214 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <cppIni/File.h>
+#include <cppIni/FrozenFile.h>
+#include "utils.h"
+
+using namespace std::literals;
+
+static const std::string fileName = std::format("{}{}", WORKING_DIR, "/res/test.ini");
+
+TEST_SUITE_BEGIN("FrozenFile");
+
+TEST_CASE("Freeze test.ini")
+{
+    const auto f = File{fileName};
+    const auto frozen = f.freeze();
+
+    CHECK_EQ(frozen.sections().size(), f.sections().size());
+    CHECK_EQ(frozen.size(), 5);
+    CHECK_EQ(frozen.get<int>("Section1", "IntEntry"), 42);
+    CHECK_EQ(frozen.get<double>("Section1.Subsection1", "DoubleEntry"), 3.1415);
+    CHECK_EQ(frozen.get<std::string_view>("Section1.Subsection2", "StringEntry"), "Hello World!"sv);
+    CHECK(frozen.get<bool>("Section1.Subsection2.Subsubsection1", "BoolEntry"));
+    CHECK_EQ(frozen.tryGet<int>("Section1", "Entry1"), std::nullopt);
+    CHECK_EQ(frozen.get<int>("Section1", "NonExisting"), 0);
+}
+
+TEST_CASE("Find sections and entries in a FrozenFile")
+{
+    const auto f = File{fileName};
+    const auto frozen = f.freeze();
+
+    const auto section = frozen.findSection("Section1.Subsection2.Subsubsection1");
+    REQUIRE(section);
+    CHECK_EQ(*section, *f.findSection("Section1.Subsection2.Subsubsection1"));
+    REQUIRE(section->parent());
+    CHECK_EQ(section->parent(), frozen.findSection("Section1.Subsection2"));
+    CHECK_EQ(frozen.findSection("Section2"), nullptr);
+    CHECK_EQ(frozen.findSection("Subsection1"), nullptr);
+
+    const auto entry = frozen.findEntry("Section1.Subsection1", "DoubleEntry");
+    REQUIRE(entry);
+    CHECK_EQ(entry, frozen.findEntry("Section1.Subsection1.DoubleEntry"));
+    CHECK_EQ(entry->parent(), frozen.findSection("Section1.Subsection1"));
+    CHECK_EQ(entry->fqKey(), "Section1.Subsection1.DoubleEntry");
+    CHECK_EQ(frozen.findEntry("Section1", "DoubleEntry"), nullptr);
+    CHECK_EQ(frozen.findEntry("Section1", "NonExisting"), nullptr);
+    CHECK_EQ(frozen.findEntry("NonExisting", "Entry1"), nullptr);
+    CHECK_EQ(frozen.findEntry("Entry1"), nullptr);
+}
+
+TEST_CASE("A FrozenFile does not change with its File")
+{
+    auto f = File{fileName, {.autoFlush = false}};
+    auto frozen = std::optional<FrozenFile>{f.freeze()};
+
+    f.set("Section1", "IntEntry", 43);
+    f.set("Section3", "Key", "Value");
+    CHECK_EQ(frozen->get<int>("Section1", "IntEntry"), 42);
+    CHECK_EQ(frozen->findSection("Section3"), nullptr);
+
+    auto moved = std::move(*frozen);
+    frozen = f.freeze();
+    CHECK_EQ(moved.get<int>("Section1", "IntEntry"), 42);
+    CHECK_EQ(frozen->get<int>("Section1", "IntEntry"), 43);
+    CHECK_EQ(frozen->get<std::string_view>("Section3", "Key"), "Value"sv);
+
+    moved = std::move(*frozen);
+    frozen.reset();
+    CHECK_EQ(moved.get<int>("Section1", "IntEntry"), 43);
+}
+
+TEST_CASE("Freeze a file with many sections and entries")
+{
+    auto f = File{fileName, {.autoFlush = false}};
+
+    for (auto i = 0; i < 200; ++i) {
+        for (auto j = 0; j < 50; ++j) {
+            f.set(std::format("Generated{}.Subsection", i), std::format("Key{}", j), i * 100 + j);
+        }
+    }
+
+    const auto frozen = f.freeze();
+    CHECK_EQ(frozen.size(), 5 + 200 * 50);
+
+    for (const auto section : f.sections()) {
+        REQUIRE(frozen.findSection(section->fqTitle()));
+        CHECK_EQ(frozen.findSection(section->fqTitle())->fqTitle(), section->fqTitle());
+
+        for (const auto& [key, entry] : section->entries()) {
+            const auto copy = frozen.findEntry(section->fqTitle(), key);
+            REQUIRE(copy);
+            CHECK_EQ(copy->data(), entry.data());
+        }
+    }
+
+    CHECK_EQ(frozen.get<int>("Generated199.Subsection", "Key49"), 19949);
+    CHECK_EQ(frozen.findEntry("Generated199.Subsection", "Key50"), nullptr);
+    CHECK_EQ(frozen.findEntry("Generated200.Subsection", "Key0"), nullptr);
+}
+
+TEST_CASE("Duplicate sections are found like in the File")
+{
+    const auto testFileName = std::string{"frozen.ini"};
+    {
+        auto out = std::ofstream{testFileName, std::ios::binary};
+        out << "[A]\nKey=1\n[A]\nKey=2\nOther=3\n";
+    }
+
+    const auto f = File{testFileName};
+    const auto frozen = f.freeze();
+
+    CHECK_EQ(frozen.sections().size(), 2);
+    CHECK_EQ(frozen.findSection("A"), &frozen.sections().front());
+    CHECK_EQ(frozen.get<int>("A", "Key"), f.get<int>("A", "Key"));
+    CHECK_EQ(frozen.findEntry("A", "Other"), nullptr);
+    CHECK_EQ(f.findEntry("A", "Other"), nullptr);
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Freeze an empty file")
+{
+    const auto testFileName = std::string{"frozen.ini"};
+    std::ofstream{testFileName};
+
+    const auto frozen = File{testFileName}.freeze();
+    CHECK(frozen.sections().empty());
+    CHECK_EQ(frozen.findSection("A"), nullptr);
+    CHECK_EQ(frozen.findEntry("A", "Key"), nullptr);
+
+    std::filesystem::remove(testFileName);
+}
+
+TEST_CASE("Lookups in a FrozenFile do not allocate")
+{
+    const auto frozen = File{fileName}.freeze();
+
+    const utils::AllocationCounter counter;
+
+    const auto section = frozen.findSection("Section1.Subsection2.Subsubsection1");
+    const auto entry = frozen.findEntry("Section1.Subsection1.DoubleEntry");
+    const auto missing = frozen.findEntry("Section1", "NonExisting");
+    const auto value = frozen.get<std::string_view>("Section1.Subsection2", "StringEntry");
+    const auto number = frozen.get<int>("Section1", "IntEntry");
+
+    CHECK_EQ(counter.count(), 0);
+
+    CHECK(section);
+    CHECK(entry);
+    CHECK_FALSE(missing);
+    CHECK_EQ(value, "Hello World!"sv);
+    CHECK_EQ(number, 42);
+}
+
+TEST_CASE("Read a FrozenFile from several threads")
+{
+    auto f = File{fileName, {.autoFlush = false}};
+
+    for (auto i = 0; i < 100; ++i) {
+        f.set("Numbers", std::format("Key{}", i), i);
+    }
+
+    const auto frozen = f.freeze();
+    std::atomic<int> errors {0};
+    std::vector<std::thread> threads;
+
+    for (auto t = 0; t < 4; ++t) {
+        threads.emplace_back([&frozen, &errors] {
+            for (auto round = 0; round < 100; ++round) {
+                for (auto i = 0; i < 100; ++i) {
+                    const auto key = std::format("Key{}", i);
+                    if (frozen.get<int>("Numbers", key) != i or frozen.tryGet<double>("Numbers", key) != i) {
+                        ++errors;
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK_EQ(errors.load(), 0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,114 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <doctest/doctest.h>
+
+#include <array>
+#include <random>
+
+#include "LineScanner.h"
+
+/// \brief Classifies a block one byte at a time, independent of every kernel
+static auto expectedMasks(const char* block) -> BlockMasks
+{
+    auto masks = BlockMasks{0, 0};
+
+    for (std::size_t i = 0; i < scanBlockSize; ++i) {
+        if (block[i] == '\n') {
+            masks.newlines |= std::uint64_t{1} << i;
+        }
+        if (block[i] == '=') {
+            masks.separators |= std::uint64_t{1} << i;
+        }
+    }
+
+    return masks;
+}
+
+/// \brief Checks every available kernel against expectedMasks(), at an aligned and an unaligned address
+static auto checkKernels(const std::array<char, scanBlockSize>& block) -> void
+{
+    // Room to move the block to an odd address
+    alignas(64) std::array<char, scanBlockSize * 2> buffer {};
+    const auto expected = expectedMasks(block.data());
+
+    for (std::size_t offset : {0, 1}) {
+        std::memcpy(buffer.data() + offset, block.data(), block.size());
+
+        for (std::size_t kernel = 0; kernel < blockScanners().size(); ++kernel) {
+            CAPTURE(kernel);
+            CAPTURE(offset);
+            const auto masks = blockScanners()[kernel](buffer.data() + offset);
+            CHECK_EQ(masks.newlines, expected.newlines);
+            CHECK_EQ(masks.separators, expected.separators);
+        }
+    }
+}
+
+TEST_SUITE_BEGIN("LineScanner");
+
+TEST_CASE("The portable kernel is always available and the fastest one is selected")
+{
+    REQUIRE_FALSE(blockScanners().empty());
+    CHECK_EQ(blockScanner(), blockScanners().front());
+}
+
+TEST_CASE("All kernels find line breaks and separators at the edges of their lanes")
+{
+    constexpr auto positions = std::array<std::size_t, 6>{0, 15, 16, 31, 32, 63};
+
+    for (const auto newline : positions) {
+        for (const auto separator : positions) {
+            auto block = std::array<char, scanBlockSize>{};
+            block.fill('a');
+            block[separator] = '=';
+            // A line break at the same position replaces the separator
+            block[newline] = '\n';
+            checkKernels(block);
+        }
+    }
+
+    auto block = std::array<char, scanBlockSize>{};
+    checkKernels(block);
+    block.fill('\n');
+    checkKernels(block);
+    block.fill('=');
+    checkKernels(block);
+    // Bytes with the high bit set must not match, even if their lower bits equal '\n' or '='
+    block.fill(static_cast<char>('\n' | 0x80));
+    checkKernels(block);
+    block.fill(static_cast<char>('=' | 0x80));
+    checkKernels(block);
+}
+
+TEST_CASE("All kernels agree on random blocks")
+{
+    constexpr auto alphabet = std::array<char, 8>{'\n', '=', '\r', ' ', 'a', '[', static_cast<char>(0x8A), static_cast<char>(0xBD)};
+    auto engine = std::mt19937{42};
+    auto pick = std::uniform_int_distribution<std::size_t>{0, alphabet.size() - 1};
+
+    for (auto i = 0; i < 10'000; ++i) {
+        auto block = std::array<char, scanBlockSize>{};
+        for (auto& byte : block) {
+            byte = alphabet[pick(engine)];
+        }
+        checkKernels(block);
+    }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,169 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <doctest/doctest.h>
+
+#include <format>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cppIni/File.h>
+#include <cppIni/Parser.h>
+#include "utils.h"
+
+using namespace std::literals;
+
+static const std::string fileName = std::format("{}{}", WORKING_DIR, "/res/test.ini");
+
+/// \brief Handler that records every title and entry as text
+struct Recorder {
+    std::vector<std::string> sections;
+    std::vector<std::string> entries;
+
+    auto section(const ParsedSection& section) -> void { sections.emplace_back(section.fqTitle); }
+    auto entry(const ParsedEntry& entry) -> void { entries.push_back(std::format("{}.{}={}", entry.section, entry.key, entry.value)); }
+};
+
+TEST_SUITE_BEGIN("Parser");
+
+TEST_CASE("Parse test.ini like a File")
+{
+    auto recorder = Recorder{};
+    CHECK(Parser::parse(fileName, recorder));
+
+    const auto f = File{fileName};
+    auto sections = std::vector<std::string>{};
+    auto entries = std::vector<std::string>{};
+
+    for (const auto section : f.sections()) {
+        sections.emplace_back(section->fqTitle());
+
+        for (const auto& [key, entry] : section->entries()) {
+            entries.push_back(std::format("{}.{}={}", section->fqTitle(), key, entry.data()));
+        }
+    }
+
+    CHECK_EQ(recorder.sections, sections);
+    CHECK_EQ(recorder.entries, entries);
+}
+
+TEST_CASE("Relative titles, parents and lines without a separator")
+{
+    auto input = std::istringstream{"Outside=1\n[A]\nKey=1\n\n[.B]\nFlag\n[A.C]\nValue=a=b\n[.D]\nEmpty=\n[E.F]"};
+    auto recorder = Recorder{};
+    auto parser = Parser{};
+
+    const auto sections = std::vector<std::string>{"A", "A.B", "A.C", "A.C.D", "E.F"};
+    const auto entries = std::vector<std::string>{".Outside=1", "A.Key=1", "A.B.Flag=Flag", "A.C.Value=a=b", "A.C.D.Empty="};
+
+    CHECK(parser.parse(input, recorder));
+    CHECK_EQ(recorder.sections, sections);
+    CHECK_EQ(recorder.entries, entries);
+    CHECK_EQ(parser.section(), "E.F");
+    CHECK_EQ(parser.offset(), input.str().size());
+    CHECK_FALSE(parser.endsWithNewline());
+}
+
+TEST_CASE("Positions of titles and entries")
+{
+    struct Positions {
+        std::vector<std::size_t> offsets;
+
+        auto section(const ParsedSection& section) -> void
+        {
+            CHECK_EQ(section.line, "[.Sub]"sv);
+            CHECK_EQ(section.title, "Sub"sv);
+            CHECK(section.relative);
+            offsets.push_back(section.offset);
+        }
+
+        auto entry(const ParsedEntry& entry) -> void
+        {
+            CHECK_EQ(entry.line.substr(entry.key.size() + 1), entry.value);
+            offsets.push_back(entry.offset);
+        }
+    };
+
+    auto input = std::istringstream{"[.Sub]\nA=1\n\nLong=Value\n"};
+    auto positions = Positions{};
+    auto parser = Parser{};
+
+    const auto offsets = std::vector<std::size_t>{0, 7, 12};
+
+    CHECK(parser.parse(input, positions));
+    CHECK_EQ(positions.offsets, offsets);
+    CHECK(parser.endsWithNewline());
+}
+
+TEST_CASE("Stop the parser from a handler")
+{
+    struct Finder {
+        std::string value;
+
+        auto entry(const ParsedEntry& entry) -> bool
+        {
+            if (entry.section == "Section1.Subsection1" and entry.key == "DoubleEntry") {
+                value = entry.value;
+                return false;
+            }
+
+            return true;
+        }
+    };
+
+    auto finder = Finder{};
+    CHECK_FALSE(Parser::parse(fileName, finder));
+    CHECK_EQ(finder.value, "3.1415");
+
+    CHECK_THROWS_AS(Parser::parse("nonexistent.ini", finder), std::runtime_error);
+}
+
+TEST_CASE("Parsing does not allocate for every line")
+{
+    struct Counter {
+        std::size_t sections {0};
+        std::size_t entries {0};
+
+        auto section(const ParsedSection&) -> void { ++sections; }
+        auto entry(const ParsedEntry&) -> void { ++entries; }
+    };
+
+    const auto allocationsFor = [](int count) {
+        auto text = std::string{};
+        for (auto i = 0; i < count; ++i) {
+            text += std::format("[Section{:05}]\nKey=Value{:05}\n[.Sub]\nOther=1\n", i, i);
+        }
+
+        auto input = std::istringstream{text};
+        auto handler = Counter{};
+        auto parser = Parser{};
+
+        const utils::AllocationCounter counter;
+        parser.parse(input, handler);
+        const auto allocations = counter.count();
+
+        CHECK_EQ(handler.sections, 2 * count);
+        CHECK_EQ(handler.entries, 2 * count);
+        return allocations;
+    };
+
+    CHECK_EQ(allocationsFor(10000), allocationsFor(10));
+}
+
+TEST_SUITE_END();
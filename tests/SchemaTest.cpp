@@ -0,0 +1,128 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <format>
+#include <sstream>
+#include <string>
+
+#include <cppIni/File.h>
+#include <cppIni/Schema.h>
+#include "utils.h"
+
+using namespace std::literals;
+
+static const std::string fileName = std::format("{}{}", WORKING_DIR, "/res/test.ini");
+
+/// \brief The values of test.ini
+struct TestValues {
+    std::string entry1 {"Default"};
+    int intEntry {0};
+    double doubleEntry {0.0};
+    std::string stringEntry {};
+    bool boolEntry {false};
+    long missing {-1};
+};
+
+using TestSchema = Schema<TestValues,
+                          Field<"Section1", "Entry1", &TestValues::entry1>,
+                          Field<"Section1.Subsection1", "DoubleEntry", &TestValues::doubleEntry>,
+                          Field<"Section1", "IntEntry", &TestValues::intEntry>,
+                          Field<"Section1.Subsection2", "StringEntry", &TestValues::stringEntry>,
+                          Field<"Section1.Subsection2.Subsubsection1", "BoolEntry", &TestValues::boolEntry>,
+                          Field<"Section2", "Missing", &TestValues::missing>>;
+
+static auto checkTestValues(const TestValues& values) -> void
+{
+    CHECK_EQ(values.entry1, "Value1");
+    CHECK_EQ(values.intEntry, 42);
+    CHECK_EQ(values.doubleEntry, 3.1415);
+    CHECK_EQ(values.stringEntry, "Hello World!");
+    CHECK(values.boolEntry);
+    CHECK_EQ(values.missing, -1);
+}
+
+TEST_SUITE_BEGIN("Schema");
+
+TEST_CASE("Load a struct from a File")
+{
+    checkTestValues(TestSchema::load(File{fileName}));
+    checkTestValues(TestSchema::load(File{fileName, {.loadMode = LoadMode::Lazy, .threadSafe = true}}));
+    checkTestValues(TestSchema::load(File{fileName}.freeze()));
+}
+
+TEST_CASE("Parse a struct without a File")
+{
+    checkTestValues(TestSchema::parse(fileName));
+
+    auto input = std::istringstream{"[Section1]\nIntEntry=1\nIntEntry=2\n[Section1]\nIntEntry=3\n[Other]\nEntry1=x\n"};
+    const auto values = TestSchema::parse(input);
+    CHECK_EQ(values.intEntry, 1);
+    CHECK_EQ(values.entry1, "Default");
+
+    auto invalid = std::istringstream{"[Section1]\nIntEntry=many\n"};
+    CHECK_THROWS_AS(TestSchema::parse(invalid), std::invalid_argument);
+    CHECK_THROWS_AS(TestSchema::parse("nonexistent.ini"), std::runtime_error);
+}
+
+TEST_CASE("Store a struct in a File")
+{
+    utils::TempFile tmpFile(fileName);
+    auto values = TestSchema::load(File{tmpFile.filename()});
+
+    values.intEntry = 7;
+    values.stringEntry = "Changed";
+    values.missing = 123456789012;
+
+    {
+        auto f = File{tmpFile.filename()};
+        TestSchema::store(values, f);
+        CHECK_EQ(f.get<int>("Section1", "IntEntry"), 7);
+    }
+
+    const auto f = File{tmpFile.filename()};
+    CHECK_EQ(f.get<std::string_view>("Section1.Subsection2", "StringEntry"), "Changed"sv);
+    CHECK_EQ(f.get<long>("Section2", "Missing"), 123456789012);
+    CHECK_EQ(f.get<double>("Section1.Subsection1", "DoubleEntry"), 3.1415);
+
+    const auto reloaded = TestSchema::load(f);
+    CHECK_EQ(reloaded.intEntry, 7);
+    CHECK_EQ(reloaded.missing, 123456789012);
+}
+
+TEST_CASE("Write a struct as INI text")
+{
+    auto output = std::ostringstream{};
+    TestSchema::write(TestValues{"A", 1, 0.5, "Text", true, 2}, output);
+
+    CHECK_EQ(output.str(), "[Section1]\nEntry1=A\nIntEntry=1\n\n"
+                           "[Section1.Subsection1]\nDoubleEntry=0.5\n\n"
+                           "[Section1.Subsection2]\nStringEntry=Text\n\n"
+                           "[Section1.Subsection2.Subsubsection1]\nBoolEntry=1\n\n"
+                           "[Section2]\nMissing=2\n\n");
+
+    auto input = std::istringstream{output.str()};
+    const auto parsed = TestSchema::parse(input);
+    CHECK_EQ(parsed.entry1, "A");
+    CHECK_EQ(parsed.doubleEntry, 0.5);
+    CHECK_EQ(parsed.missing, 2);
+}
+
+TEST_SUITE_END();
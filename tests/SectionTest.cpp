@@ -20,6 +20,10 @@
 
 #include <cppIni/Section.h>
 
+#include <string>
+#include <type_traits>
+#include <vector>
+
 TEST_SUITE_BEGIN("Section");
 
 class SectionFixture
@@ -221,4 +225,71 @@ TEST_CASE("Inequality of two sections")
     CHECK_NE(s1, s3);
 }
 
+TEST_CASE_FIXTURE(SectionFixture, "Entries are moved into a Section without copying their values")
+{
+    static_assert(std::is_nothrow_move_constructible_v<Entry> and std::is_nothrow_move_assignable_v<Entry>);
+    static_assert(not std::is_polymorphic_v<Entry>);
+
+    constexpr auto count = 100;
+    std::vector<const char*> values;
+
+    for (auto i = 0; i < count; ++i) {
+        auto entry = Entry{"Key" + std::to_string(i), std::string(64, static_cast<char>('a' + i % 26))};
+        values.push_back(entry.data().data());
+
+        if (i % 2 == 0) {
+            s.addEntry(std::move(entry));
+        } else {
+            s.setEntry(std::move(entry));
+        }
+    }
+
+    // A copy of a value would live somewhere else, moving the entries while the Section grows keeps them in place
+    auto copies = 0;
+    for (auto i = 0; i < count; ++i) {
+        copies += s.findEntry("Key" + std::to_string(i))->data().data() != values[i];
+    }
+
+    CHECK_EQ(s.entries().size(), count);
+    CHECK_EQ(copies, 0);
+}
+
+TEST_CASE_FIXTURE(SectionFixture, "Copied and moved Sections are the parents of their entries")
+{
+    static_assert(std::is_nothrow_move_constructible_v<Section> and std::is_nothrow_move_assignable_v<Section>);
+
+    s.createEntry("A", 1);
+    s.createEntry("B", 2);
+    s.addEntry({"Orphan", 3});
+
+    const auto copy = s;
+    CHECK_EQ(copy, s);
+    CHECK_EQ(copy.findEntry("A")->parent(), &copy);
+    CHECK_EQ(copy.findEntry("Orphan")->parent(), nullptr);
+    CHECK_EQ(s.findEntry("A")->parent(), &s);
+
+    auto moved = std::move(s);
+    CHECK_EQ(moved.title(), title);
+    CHECK_EQ(moved.findEntry("B")->parent(), &moved);
+
+    // A moved-from Section keeps its title and can be filled again
+    CHECK(s.entries().empty());
+    CHECK_EQ(s.title(), title);
+    s.createEntry("C", 4);
+    CHECK_EQ(s.findEntry("C")->parent(), &s);
+
+    auto assigned = Section{"Other"};
+    assigned = std::move(moved);
+    CHECK_EQ(assigned.title(), title);
+    CHECK_EQ(assigned.findEntry("A")->parent(), &assigned);
+    CHECK_EQ(assigned.findEntry("B")->value<int>(), 2);
+    CHECK(moved.entries().empty());
+    moved.addEntry({"D", 5});
+    CHECK_EQ(moved.findEntry("D")->value<int>(), 5);
+
+    assigned = copy;
+    CHECK_EQ(assigned.findEntry("A")->parent(), &assigned);
+    CHECK_EQ(copy.findEntry("A")->parent(), &copy);
+}
+
 TEST_SUITE_END();
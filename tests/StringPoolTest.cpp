@@ -0,0 +1,93 @@
+/*
+ * cppIni - A C++20 library for reading and writing INI files
+ * Copyright (C) 2024 Nils Hofmann <nils.friedchen@googlemail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <doctest/doctest.h>
+
+#include <cppIni/File.h>
+#include <cppIni/StringPool.h>
+
+using namespace std::literals;
+
+static const std::string fileName = std::format("{}{}", WORKING_DIR, "/res/test.ini");
+
+TEST_SUITE_BEGIN("StringPool");
+
+TEST_CASE("Intern equal strings only once")
+{
+    StringPool pool;
+
+    const auto first = pool.intern("Key");
+    const auto second = pool.intern(std::string("Key"));
+    const auto other = pool.intern("Other key");
+
+    CHECK_EQ(first, "Key"sv);
+    CHECK_EQ(first.data(), second.data());
+    CHECK_NE(first.data(), other.data());
+    CHECK_EQ(pool.size(), 2);
+}
+
+TEST_CASE("Interned strings stay valid while the pool grows")
+{
+    StringPool pool;
+
+    const auto first = pool.intern("First");
+    for (auto i = 0; i < 100'000; ++i) {
+        pool.intern(std::to_string(i));
+    }
+    const auto large = pool.intern(std::string(100'000, 'x'));
+
+    CHECK_EQ(first, "First"sv);
+    CHECK_EQ(pool.intern("First").data(), first.data());
+    CHECK_EQ(large.size(), 100'000);
+    CHECK_EQ(pool.size(), 100'002);
+}
+
+TEST_CASE("Share a pool between files")
+{
+    const auto pool = std::make_shared<StringPool>();
+
+    const auto f1 = File{fileName, {.stringPool = pool}};
+    const auto stringsAfterFirstFile = pool->size();
+    const auto f2 = File{fileName, {.loadMode = LoadMode::Mapped, .stringPool = pool}};
+
+    CHECK_EQ(f1.stringPool(), pool);
+    CHECK_EQ(f1, f2);
+    CHECK_EQ(pool->size(), stringsAfterFirstFile);
+
+    const auto e1 = f1.findEntry("Section1.Entry1");
+    const auto e2 = f2.findEntry("Section1.Entry1");
+    REQUIRE(e1);
+    REQUIRE(e2);
+    CHECK_EQ(e1->key().data(), e2->key().data());
+    CHECK_EQ(e1->data().data(), e2->data().data());
+    CHECK_EQ(f1.findSection("Section1.Subsection2")->fqTitle().data(), f2.findSection("Section1.Subsection2")->fqTitle().data());
+}
+
+TEST_CASE("Long values are not interned")
+{
+    const auto pool = std::make_shared<StringPool>(4);
+
+    const auto f1 = File{fileName, {.stringPool = pool}};
+    const auto f2 = File{fileName, {.stringPool = pool}};
+
+    CHECK_EQ(f1.findEntry("Section1.IntEntry")->data().data(), f2.findEntry("Section1.IntEntry")->data().data());
+    CHECK_NE(f1.findEntry("Section1.Entry1")->data().data(), f2.findEntry("Section1.Entry1")->data().data());
+    CHECK_EQ(f1.get<std::string_view>("Section1", "Entry1"), "Value1"sv);
+}
+
+TEST_SUITE_END();
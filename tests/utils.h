@@ -18,11 +18,31 @@
 
 #pragma once
 
+#include <atomic>
 #include <filesystem>
 
 namespace utils
 {
 
+/// \brief Number of calls to the global operator new since the start of the test executable
+///
+/// \details The replacement operators that update the counter are defined in FileTest.cpp.
+extern std::atomic<std::size_t> allocations;
+
+/// \brief Class for counting heap allocations in a scope
+///
+/// \details The counter starts when the object is constructed. count() returns the number of allocations since then.
+class AllocationCounter
+{
+public:
+    AllocationCounter() : m_start(allocations.load()) {}
+
+    std::size_t count() const { return allocations.load() - m_start; }
+
+private:
+    std::size_t m_start;
+};
+
 /// \brief Class for managing lifetime of a pointer
 ///
 /// \details This class is a RAII wrapper for raw pointers. It is intended to be used as automatic variable in a function